@@ -0,0 +1,242 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Arbitrage_Monitor_H
+#define Arbitrage_Monitor_H
+
+#include <unordered_map>
+#include "pathFindingBase.h"
+#include "bellmanFordAlgorithm.h"
+
+/// <summary>
+/// Profitable (negative) cycle reported on a tick.
+/// </summary>
+struct CycleSignal
+{
+    vector<int> Cycle;
+    double Weight;
+    bool FromWatchlist; // True if found by revalidation of a known cycle, false if by full search.
+};
+
+/// <summary>
+/// Incremental arbitrage detection over a graph that changes tick by tick.
+///
+/// Most profitable cycles live for several ticks, so every cycle found by full search is kept in a watchlist.
+/// On a tick only watched cycles containing an updated edge are re-evaluated, in O(cycle length), and every watched cycle
+/// that is still negative is signalled immediately. Full search (BellmanFordAlgorithm::FindNegativeCycle) runs only when
+/// no watched cycle is profitable anymore, or every fullSearchInterval ticks to discover new cycles.
+/// When the last full search found no cycle and every update of a tick is a no-op for its solution (see _IsNoOp),
+/// the tick is not solved at all.
+/// </summary>
+class ArbitrageMonitor
+{
+public:
+    ArbitrageMonitor(Graph& graph, int start, size_t watchlistCapacity = 16, int fullSearchInterval = 8)
+        : _graph(graph),
+          _start(start),
+          _watchlistCapacity(watchlistCapacity),
+          _fullSearchInterval(fullSearchInterval)
+    {
+    }
+
+    /// <summary>
+    /// Applies the updates to the graph and returns profitable cycles after them.
+    /// </summary>
+    vector<CycleSignal> OnTick(const vector<EdgeUpdate>& updates)
+    {
+        _tick++;
+
+        // Classify before applying: tree edges are recognized by the old state.
+        bool noOp = true;
+        for (const EdgeUpdate& update : updates)
+        {
+            if (!_IsNoOp(update))
+            {
+                noOp = false;
+                break;
+            }
+        }
+
+        for (const EdgeUpdate& update : updates)
+        {
+            _graph.Matrix[update.From][update.To] = update.Weight;
+        }
+
+        vector<CycleSignal> signals = _RevalidateWatchlist(updates);
+
+        if (_solutionValid && noOp)
+        {
+            // Distances and shortest path tree are still exact and prove there is no negative cycle reachable from start.
+            _skippedSolves++;
+            return signals;
+        }
+
+        if (signals.empty() || _tick - _lastFullSearch >= _fullSearchInterval)
+        {
+            _FullSearch(signals);
+        }
+        else
+        {
+            _solutionValid = false;
+        }
+
+        return signals;
+    }
+
+    size_t WatchlistSize() const
+    {
+        return _watchlist.size();
+    }
+
+    int FullSearches() const
+    {
+        return _fullSearches;
+    }
+
+    int SkippedSolves() const
+    {
+        return _skippedSolves;
+    }
+
+private:
+    struct WatchedCycle
+    {
+        vector<int> Cycle;
+        double Weight;
+        int LastProfitableTick;
+    };
+
+    Graph& _graph;
+    int _start;
+    size_t _watchlistCapacity;
+    int _fullSearchInterval;
+    int _tick = 0;
+    int _lastFullSearch = 0;
+    int _fullSearches = 0;
+    int _skippedSolves = 0;
+    bool _solutionValid = false; // _solver holds exact distances from start and there is no negative cycle reachable from it.
+    BellmanFordAlgorithm _solver;
+    vector<WatchedCycle> _watchlist;
+    unordered_map<long long, vector<int>> _cyclesByEdge; // Edge key -> indexes in _watchlist of cycles using the edge.
+
+    long long _EdgeKey(int from, int to) const
+    {
+        return (long long)from * _graph.Nodes.size() + to;
+    }
+
+    /// <summary>
+    /// O(1) check that an update cannot change the current solution (valid only if there is one):
+    /// the edge is not on the shortest path tree and its reduced cost w + d[from] - d[to] stays non-negative,
+    /// so no distance improves and no negative cycle appears.
+    /// </summary>
+    bool _IsNoOp(const EdgeUpdate& update) const
+    {
+        if (!_solutionValid)
+        {
+            return false;
+        }
+
+        if (_solver._previousVertex[update.To] == update.From) // Edge of the shortest path tree.
+        {
+            return update.Weight == _graph.Matrix[update.From][update.To];
+        }
+
+        const vector<double>& distance = _solver._shortestPath;
+        if (distance[update.From] == INF || update.Weight == INF) // Source not reachable from start or edge removed.
+        {
+            return true;
+        }
+
+        return update.Weight + distance[update.From] - distance[update.To] >= 0;
+    }
+
+    vector<CycleSignal> _RevalidateWatchlist(const vector<EdgeUpdate>& updates)
+    {
+        // Re-evaluate only cycles touched by this tick, each one once.
+        vector<char> touched(_watchlist.size(), 0);
+        for (const EdgeUpdate& update : updates)
+        {
+            auto found = _cyclesByEdge.find(_EdgeKey(update.From, update.To));
+            if (found == _cyclesByEdge.end())
+            {
+                continue;
+            }
+
+            for (int index : found->second)
+            {
+                if (!touched[index])
+                {
+                    touched[index] = 1;
+                    _watchlist[index].Weight = BellmanFordAlgorithm::CycleWeight(_graph, _watchlist[index].Cycle);
+                }
+            }
+        }
+
+        vector<CycleSignal> signals;
+        for (WatchedCycle& watched : _watchlist)
+        {
+            if (watched.Weight < 0)
+            {
+                watched.LastProfitableTick = _tick;
+                signals.push_back({ watched.Cycle, watched.Weight, true });
+            }
+        }
+
+        return signals;
+    }
+
+    void _FullSearch(vector<CycleSignal>& signals)
+    {
+        _lastFullSearch = _tick;
+        _fullSearches++;
+
+        vector<int> cycle = _solver.FindNegativeCycle(_graph, _start);
+        _solutionValid = cycle.empty();
+        if (cycle.empty())
+        {
+            return;
+        }
+
+        // Same cycle may be returned starting from another vertex: compare in canonical rotation (smallest vertex first).
+        rotate(cycle.begin(), min_element(cycle.begin(), cycle.end()), cycle.end());
+        for (const WatchedCycle& watched : _watchlist)
+        {
+            if (watched.Cycle == cycle)
+            {
+                return; // Already watched and signalled.
+            }
+        }
+
+        double weight = BellmanFordAlgorithm::CycleWeight(_graph, cycle);
+        signals.push_back({ cycle, weight, false });
+
+        if (_watchlist.size() >= _watchlistCapacity)
+        {
+            // Evict the cycle that has not been profitable for the longest time.
+            auto oldest = min_element(_watchlist.begin(), _watchlist.end(), [](const WatchedCycle& a, const WatchedCycle& b)
+            {
+                return a.LastProfitableTick < b.LastProfitableTick;
+            });
+            _watchlist.erase(oldest);
+        }
+
+        _watchlist.push_back({ cycle, weight, _tick });
+        _RebuildEdgeIndex();
+    }
+
+    void _RebuildEdgeIndex()
+    {
+        _cyclesByEdge.clear();
+        for (int index = 0; index < (int)_watchlist.size(); index++)
+        {
+            const vector<int>& cycle = _watchlist[index].Cycle;
+            for (size_t i = 0; i < cycle.size(); i++)
+            {
+                _cyclesByEdge[_EdgeKey(cycle[i], cycle[(i + 1) % cycle.size()])].push_back(index);
+            }
+        }
+    }
+};
+
+#endif
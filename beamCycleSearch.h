@@ -0,0 +1,250 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Beam_Cycle_Search_H
+#define Beam_Cycle_Search_H
+
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include "pathFindingBase.h"
+#include "bellmanFordAlgorithm.h"
+#include "circuitEnumerator.h"
+
+/// <summary>
+/// Fast heuristic detector of negative cycles for graphs where exact detection does not fit the time budget.
+///
+/// From every start vertex paths grow one edge per step. A step relaxes every kept path over its whole matrix row into the
+/// best weight per end vertex (a branch free min over contiguous memory, which compilers vectorize), and then only the
+/// beamWidth best end vertices are kept for the next step. Before growing, every kept path is closed back to the start.
+/// Start vertices are shared between threads through an atomic counter.
+/// Every candidate is then verified exactly: it must be a simple cycle and its weight is summed again from Graph::Matrix.
+/// The result may miss cycles (an empty result proves nothing), but every returned cycle is real.
+/// </summary>
+class BeamCycleSearch
+{
+public:
+    BeamCycleSearch(int beamWidth, int maxLength, int threadsNumber = 0)
+        : _beamWidth(beamWidth),
+          _maxLength(maxLength),
+          _threadsNumber(threadsNumber > 0 ? threadsNumber : max(1, (int)thread::hardware_concurrency()))
+    {
+    }
+
+    /// <summary>
+    /// Returns distinct verified negative cycles (smallest vertex first), the most negative first.
+    /// </summary>
+    vector<Circuit> Find(const Graph& graph)
+    {
+        int verticesNumber = graph.Matrix.size();
+        atomic<int> nextStart(0);
+        int threadsNumber = max(1, min(_threadsNumber, verticesNumber));
+        vector<vector<Circuit>> buffers(threadsNumber);
+
+        vector<thread> threads;
+        threads.reserve(threadsNumber);
+        for (int t = 0; t < threadsNumber; t++)
+        {
+            threads.emplace_back([this, &graph, &nextStart, &buffers, t, verticesNumber]()
+            {
+                for (int start = nextStart++; start < verticesNumber; start = nextStart++)
+                {
+                    _Grow(graph, start, buffers[t]);
+                }
+            });
+        }
+        for (thread& worker : threads)
+        {
+            worker.join();
+        }
+
+        vector<Circuit> circuits;
+        _candidates = 0;
+        for (vector<Circuit>& buffer : buffers)
+        {
+            _candidates += buffer.size();
+            for (Circuit& candidate : buffer)
+            {
+                if (_Verify(graph, candidate))
+                {
+                    circuits.push_back(candidate);
+                }
+            }
+        }
+
+        sort(circuits.begin(), circuits.end(), [](const Circuit& a, const Circuit& b)
+        {
+            return a.Cycle != b.Cycle ? a.Cycle < b.Cycle : a.Weight < b.Weight;
+        });
+        circuits.erase(unique(circuits.begin(), circuits.end(), [](const Circuit& a, const Circuit& b) { return a.Cycle == b.Cycle; }),
+            circuits.end());
+        sort(circuits.begin(), circuits.end(), [](const Circuit& a, const Circuit& b)
+        {
+            return a.Weight != b.Weight ? a.Weight < b.Weight : a.Cycle < b.Cycle;
+        });
+
+        return circuits;
+    }
+
+    /// <summary>
+    /// Closed paths proposed by the last Find before verification (one start may find the same cycle as another).
+    /// </summary>
+    size_t Candidates() const
+    {
+        return _candidates;
+    }
+
+private:
+    /// <summary>
+    /// Path kept in the beam: end vertex, parent in the previous layer and weight.
+    /// </summary>
+    struct Step
+    {
+        int Vertex;
+        int Parent;
+        double Weight;
+    };
+
+    int _beamWidth;
+    int _maxLength;
+    int _threadsNumber;
+    size_t _candidates = 0;
+
+    void _Grow(const Graph& graph, int start, vector<Circuit>& output) const
+    {
+        int verticesNumber = graph.Matrix.size();
+        vector<vector<Step>> layers(1, { { start, -1, 0.0 } });
+        vector<double> best(verticesNumber);
+        vector<int> from(verticesNumber);
+        vector<int> order(verticesNumber);
+
+        for (int length = 1; length <= _maxLength; length++)
+        {
+            const vector<Step>& layer = layers.back();
+
+            if (length > 1)
+            {
+                for (int i = 0; i < (int)layer.size(); i++)
+                {
+                    double closed = layer[i].Weight + graph.Matrix[layer[i].Vertex][start];
+                    if (graph.Matrix[layer[i].Vertex][start] != INF && closed < 0)
+                    {
+                        output.push_back({ _Path(layers, layers.size() - 1, i), closed });
+                    }
+                }
+            }
+            if (length == _maxLength)
+            {
+                break;
+            }
+
+            fill(best.begin(), best.end(), INF);
+            for (int i = 0; i < (int)layer.size(); i++)
+            {
+                double weight = layer[i].Weight;
+                const double* row = graph.Matrix[layer[i].Vertex].data();
+                for (int to = 0; to < verticesNumber; to++)
+                {
+                    double candidate = weight + row[to];
+                    bool better = candidate < best[to];
+                    best[to] = better ? candidate : best[to];
+                    from[to] = better ? i : from[to];
+                }
+            }
+
+            // Keep the beamWidth best end vertices reached by simple paths.
+            int kept = 0;
+            for (int to = 0; to < verticesNumber; to++)
+            {
+                if (to == start || best[to] >= INF / 2)
+                {
+                    continue;
+                }
+
+                if (_OnPath(layers, from[to], to))
+                {
+                    // Best path to it is not simple (the diagonal, at least, always gives one): look for the best simple one.
+                    best[to] = INF;
+                    for (int i = 0; i < (int)layer.size(); i++)
+                    {
+                        double candidate = layer[i].Weight + graph.Matrix[layer[i].Vertex][to];
+                        if (graph.Matrix[layer[i].Vertex][to] != INF && candidate < best[to] && !_OnPath(layers, i, to))
+                        {
+                            best[to] = candidate;
+                            from[to] = i;
+                        }
+                    }
+                    if (best[to] == INF)
+                    {
+                        continue;
+                    }
+                }
+                order[kept++] = to;
+            }
+            int width = min(kept, _beamWidth);
+            partial_sort(order.begin(), order.begin() + width, order.begin() + kept, [&best](int a, int b) { return best[a] < best[b]; });
+
+            vector<Step> next;
+            for (int i = 0; i < width; i++)
+            {
+                next.push_back({ order[i], from[order[i]], best[order[i]] });
+            }
+            if (next.empty())
+            {
+                break;
+            }
+            layers.push_back(next);
+        }
+    }
+
+    bool _OnPath(const vector<vector<Step>>& layers, int index, int vertex) const
+    {
+        for (int layer = layers.size() - 1; layer >= 0; index = layers[layer][index].Parent, layer--)
+        {
+            if (layers[layer][index].Vertex == vertex)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static vector<int> _Path(const vector<vector<Step>>& layers, int layer, int index)
+    {
+        vector<int> path;
+        for (; layer >= 0; index = layers[layer][index].Parent, layer--)
+        {
+            path.push_back(layers[layer][index].Vertex);
+        }
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+    /// <summary>
+    /// Exact check of a candidate: simple cycle with negative weight summed from the matrix. Rotates it to start from its smallest vertex.
+    /// </summary>
+    static bool _Verify(const Graph& graph, Circuit& candidate)
+    {
+        vector<int> sorted = candidate.Cycle;
+        sort(sorted.begin(), sorted.end());
+        if (adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < candidate.Cycle.size(); i++)
+        {
+            if (graph.Matrix[candidate.Cycle[i]][candidate.Cycle[(i + 1) % candidate.Cycle.size()]] == INF)
+            {
+                return false;
+            }
+        }
+
+        rotate(candidate.Cycle.begin(), min_element(candidate.Cycle.begin(), candidate.Cycle.end()), candidate.Cycle.end());
+        candidate.Weight = BellmanFordAlgorithm::CycleWeight(graph, candidate.Cycle);
+        return candidate.Weight < 0;
+    }
+};
+
+#endif
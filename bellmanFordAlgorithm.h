@@ -0,0 +1,728 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Bellman_Ford_Algorithm_H
+#define Bellman_Ford_Algorithm_H
+
+#include <iostream>
+#include <list>
+#include <string>
+#include <algorithm>
+#include "pathFindingBase.h"
+#include "bitReachability.h"
+#include "vertexQueue.h"
+
+/// <summary>
+/// Bellman-Ford algorithm allows to find path between 2 nodes that:
+/// - Contain negative weights
+/// - Are not part of negative cycles (i.e. graph do not contain negative cycle).
+/// 
+/// Method of this class implement various algorithms to check if graph contains negative cycle and if NOT: finds path between 2 nodes by Bellman-Ford algorithm.
+/// </summary>
+class BellmanFordAlgorithm
+{
+public:
+    vector<double> _shortestPath;
+    vector<int> _previousVertex;
+    bool _solved = false;
+
+    /// <summary>
+    /// Checks if graph contains negative cycle and if NOT: finds path between 2 nodes by Bellman-Ford algorithm.
+    /// https://www.youtube.com/watch?v=24HziTZ8_xo
+    /// </summary>
+    bool ContainsNegativeCycles(Graph& graph, int start)
+    {
+        int verticesNumber = graph.Nodes.size();
+
+        _shortestPath.resize(verticesNumber, INF);
+        _previousVertex.resize(verticesNumber, -1);
+
+        _shortestPath[start] = 0;
+
+        bool updated = false;
+        // For each vertex, apply relaxation for all the edges V - 1 times.
+        // It's important that we should be able to find optimal solution for not more than V - 1 relaxation steps.
+        for (int k = 0; k < verticesNumber - 1; k++)
+        {
+            updated = false;
+            for (int from = 0; from < verticesNumber; from++)
+            {
+                for (int to = 0; to < verticesNumber; to++)
+                {
+                    if (_shortestPath[to] > _shortestPath[from] + graph.Matrix[from][to])
+                    {
+                        _shortestPath[to] = _shortestPath[from] + graph.Matrix[from][to];
+                        _previousVertex[to] = from;
+                        updated = true;
+                    }
+                }
+            }
+            if (!updated) // No changes in paths, means we can finish now.
+                break;
+        }
+
+        // Run one more relaxation step to detect which nodes are part of a negative cycle. 
+        // A negative cycle has occurred if we can find a better path beyond the optimal solution.
+        if (updated)
+        {
+            for (int from = 0; from < verticesNumber; from++)
+            {
+                for (int to = 0; to < verticesNumber; to++)
+                {
+                    if (_shortestPath[to] > _shortestPath[from] + graph.Matrix[from][to])
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+
+        _solved = true;
+
+        return false;
+    }
+
+    /// <summary>
+    /// Checks if graph contains negative cycle and if NOT: finds path between 2 nodes by Bellman-Ford algorithm.
+    /// </summary>
+    bool ContainsNegativeCycles_Sedgewick(Graph& graph, int start)
+    {
+        int n = graph.Nodes.size(); // V
+
+        _shortestPath.resize(n, INF);
+        _previousVertex.resize(n, -1);
+
+        _shortestPath[start] = 0;
+
+        bool updated = false;
+        for (size_t i = 0; i < n; ++i)
+        {
+            updated = false;
+            for (size_t from = 0; from < n; ++from)
+            {
+                for (size_t to = 0; to < n; ++to)
+                {
+                    if (from != start && _previousVertex[from] == -1)
+                        continue;
+
+                    if (graph.Matrix[from][to] == INF) // Edge not exists
+                    {
+                        continue;
+                    }
+
+                    double new_distance = _shortestPath[from] + graph.Matrix[from][to];
+                    if (_shortestPath[to] > new_distance)
+                    {
+                        _shortestPath[to] = new_distance;
+                        _previousVertex[to] = from;
+                        updated = true;
+                    }
+                }
+            }
+
+            if (i == n - 1 && updated)
+            {
+                return true; // Found negative cycle.
+            }
+        }
+
+        _solved = true;
+
+        return false;
+    }
+
+    /// <summary>
+    /// Implementation of Sedgewick Fifo algorithm for finding path in the graph with negatie weights (but not negative cycles).
+    /// Do not contain protection against cycles: on a graph with a negative cycle it just stops after V + 1 passes.
+    /// </summary>
+    void FindPathOnly(Graph& graph, int start)
+    {
+        int n = graph.Nodes.size(); // V
+
+        _shortestPath.resize(n, INF);
+        _previousVertex.resize(n, -1);
+
+        _shortestPath[start] = 0;
+
+        // Every vertex is queued at most once, and the vertices left from the current pass are counted instead of a sentinel.
+        _queue.Reset(n);
+        _queue.PushBack(start);
+        int pass = 0;
+        int leftInPass = 1;
+
+        while (!_queue.Empty())
+        {
+            if (leftInPass == 0)
+            {
+                if (++pass > n)
+                {
+                    break;
+                }
+                leftInPass = _queue.Size();
+            }
+
+            int from = _queue.PopFront();
+            leftInPass--;
+
+            for (size_t to = 0; to < graph.Nodes.size(); ++to)
+            {
+                if (graph.Matrix[from][to] == INF) // Edge not exists
+                {
+                    continue;
+                }
+
+                double new_distance = _shortestPath[from] + graph.Matrix[from][to];
+
+                if (_shortestPath[to] > new_distance)
+                {
+                    _shortestPath[to] = new_distance;
+                    _queue.PushBack(to);
+                    _previousVertex[to] = from;
+                }
+            }
+        }
+
+        _solved = true;
+    }
+
+    /// <summary>
+    /// Whilliam's Fiset implementation of the Bellman-Ford algorithm:
+    /// https://github.com/williamfiset/Algorithms/blob/master/src/main/java/com/williamfiset/algorithms/graphtheory/BellmanFordAdjacencyMatrix.java
+    /// https://github.com/williamfiset/Algorithms/blob/master/src/main/java/com/williamfiset/algorithms/graphtheory/BellmanFordEdgeList.java
+    /// 
+    /// Not only checks if graph contains negative cycle, but also points nodes that are part of the cycle.
+    /// </summary>
+    bool FindPathsAndNegativeCycles(Graph& graph, int start)
+    {
+        int verticesNumber = graph.Nodes.size();
+
+        _shortestPath.resize(verticesNumber, INF);
+        _previousVertex.resize(verticesNumber, -1);
+
+        _shortestPath[start] = 0;
+
+        // For each vertex, apply relaxation for all the edges to find PATH (if there are no negative cycles).
+        for (int k = 0; k < verticesNumber - 1; k++)
+        {
+            for (int from = 0; from < verticesNumber; from++)
+            {
+                for (int to = 0; to < verticesNumber; to++)
+                {
+                    if (graph.Matrix[from][to] == INF) // Edge not exists
+                    {
+                        continue;
+                    }
+
+                    if (_shortestPath[to] > _shortestPath[from] + graph.Matrix[from][to])
+                    {
+                        _shortestPath[to] = _shortestPath[from] + graph.Matrix[from][to];
+                        _previousVertex[to] = from;
+                    }
+                }
+            }
+        }
+
+        // Vertices that still improve after V - 1 passes are on a negative cycle or reachable from one, and so is every vertex
+        // reachable from them: instead of V - 1 more relaxation passes, one pass finds them and a bitset search marks the rest.
+        vector<int> improvable;
+        for (int from = 0; from < verticesNumber; from++)
+        {
+            for (int to = 0; to < verticesNumber; to++)
+            {
+                if (graph.Matrix[from][to] == INF) // Edge not exists
+                {
+                    continue;
+                }
+
+                if (_shortestPath[to] > _shortestPath[from] + graph.Matrix[from][to])
+                {
+                    improvable.push_back(to);
+                }
+            }
+        }
+
+        bool negativeCycles = !improvable.empty();
+        if (negativeCycles)
+        {
+            BitReachability reachability;
+            reachability.Build(graph);
+            vector<char> affected = reachability.From(improvable);
+            for (int v = 0; v < verticesNumber; v++)
+            {
+                if (affected[v])
+                {
+                    _shortestPath[v] = NEG_INF;
+                    _previousVertex[v] = -2;
+                }
+            }
+        }
+
+        _solved = true;
+
+        return negativeCycles;
+    }
+
+    /// <summary>
+    /// Finds one negative cycle reachable from start and returns its vertices in the order of the edges (first vertex is not repeated at the end).
+    /// Returns empty vector if there is no such cycle.
+    /// After V relaxation passes a vertex relaxed on the last pass leads back, through _previousVertex, into a negative cycle.
+    /// </summary>
+    vector<int> FindNegativeCycle(Graph& graph, int start)
+    {
+        int verticesNumber = graph.Nodes.size();
+
+        _shortestPath.assign(verticesNumber, INF);
+        _previousVertex.assign(verticesNumber, -1);
+        _solved = false;
+
+        _shortestPath[start] = 0;
+
+        int lastUpdated = -1;
+        for (int k = 0; k < verticesNumber; k++)
+        {
+            lastUpdated = -1;
+            for (int from = 0; from < verticesNumber; from++)
+            {
+                if (_shortestPath[from] == INF) // Not reached yet
+                {
+                    continue;
+                }
+
+                for (int to = 0; to < verticesNumber; to++)
+                {
+                    if (graph.Matrix[from][to] == INF) // Edge not exists
+                    {
+                        continue;
+                    }
+
+                    if (_shortestPath[to] > _shortestPath[from] + graph.Matrix[from][to])
+                    {
+                        _shortestPath[to] = _shortestPath[from] + graph.Matrix[from][to];
+                        _previousVertex[to] = from;
+                        lastUpdated = to;
+                    }
+                }
+            }
+
+            if (lastUpdated == -1) // No changes in paths: no negative cycle.
+                return {};
+        }
+
+        // Step back V times to be sure we are inside the cycle, not on a path leading to it.
+        int at = lastUpdated;
+        for (int i = 0; i < verticesNumber; i++)
+        {
+            at = _previousVertex[at];
+        }
+
+        vector<int> cycle;
+        for (int v = at; ; v = _previousVertex[v])
+        {
+            cycle.push_back(v);
+            if (v == at && cycle.size() > 1)
+            {
+                cycle.pop_back();
+                break;
+            }
+        }
+        reverse(cycle.begin(), cycle.end());
+
+        return cycle;
+    }
+
+    /// <summary>
+    /// Finds one negative cycle anywhere in the graph, like FindNegativeCycle from a virtual vertex connected to every vertex
+    /// with 0 weight edges. If active is not empty, only the enabled vertices and edges between them are seen
+    /// (for example the mask left by CyclePruning), so passes cost active^2 instead of V^2.
+    /// Returns empty vector if there is no such cycle. _shortestPath of inactive vertices is left INF.
+    /// </summary>
+    vector<int> FindAnyNegativeCycle(Graph& graph, const vector<char>& active = {})
+    {
+        int verticesNumber = graph.Matrix.size();
+
+        vector<int> vertices;
+        for (int v = 0; v < verticesNumber; v++)
+        {
+            if (active.empty() || active[v])
+            {
+                vertices.push_back(v);
+            }
+        }
+
+        _shortestPath.assign(verticesNumber, INF);
+        _previousVertex.assign(verticesNumber, -1);
+        _solved = false;
+        for (int v : vertices)
+        {
+            _shortestPath[v] = 0; // Edge from the virtual vertex is already relaxed.
+        }
+
+        int activeNumber = vertices.size();
+        if (activeNumber == 0)
+        {
+            return {};
+        }
+
+        int lastUpdated = -1;
+        for (int k = 0; k < activeNumber; k++)
+        {
+            lastUpdated = -1;
+            for (int from : vertices)
+            {
+                for (int to : vertices)
+                {
+                    if (graph.Matrix[from][to] == INF) // Edge not exists
+                    {
+                        continue;
+                    }
+
+                    if (_shortestPath[to] > _shortestPath[from] + graph.Matrix[from][to])
+                    {
+                        _shortestPath[to] = _shortestPath[from] + graph.Matrix[from][to];
+                        _previousVertex[to] = from;
+                        lastUpdated = to;
+                    }
+                }
+            }
+
+            if (lastUpdated == -1) // No changes in paths: no negative cycle.
+                return {};
+        }
+
+        // Step back to be sure we are inside the cycle, not on a path leading to it.
+        int at = lastUpdated;
+        for (int i = 0; i < activeNumber; i++)
+        {
+            at = _previousVertex[at];
+        }
+
+        vector<int> cycle;
+        for (int v = at; ; v = _previousVertex[v])
+        {
+            cycle.push_back(v);
+            if (v == at && cycle.size() > 1)
+            {
+                cycle.pop_back();
+                break;
+            }
+        }
+        reverse(cycle.begin(), cycle.end());
+
+        return cycle;
+    }
+
+    /// <summary>
+    /// Finds the best (most negative) simple cycle passing through the home vertex.
+    /// A single Bellman-Ford run from home gives a first cycle: after every relaxation pass, paths to the tails of in-edges of home
+    /// are closed into cycles and the best one is kept. It is already the best one if no other negative cycle is reachable from
+    /// home; otherwise such cycles distort the distances, so a depth-first search over simple paths from home follows, pruned by
+    /// the best cycle so far and by the cheapest walks back to home of every number of hops (see _WalksToHome).
+    /// The search stops after maxExpansions extended paths; then the result is the best cycle found so far.
+    /// Returns cycle starting with home, or empty vector if no negative cycle through home was found.
+    /// </summary>
+    vector<int> FindNegativeCycleThrough(Graph& graph, int home, size_t maxExpansions = 1000000)
+    {
+        int verticesNumber = graph.Nodes.size();
+
+        _shortestPath.assign(verticesNumber, INF);
+        _previousVertex.assign(verticesNumber, -1);
+        _solved = false;
+
+        _shortestPath[home] = 0;
+
+        vector<int> best;
+        double bestWeight = 0;
+        vector<char> onPath(verticesNumber, 0);
+
+        for (int k = 0; k < verticesNumber - 1; k++)
+        {
+            bool updated = false;
+            for (int from = 0; from < verticesNumber; from++)
+            {
+                if (_shortestPath[from] == INF) // Not reached yet
+                {
+                    continue;
+                }
+
+                for (int to = 0; to < verticesNumber; to++)
+                {
+                    // Edges into home close cycles below, home itself stays the root of the tree.
+                    if (to == home || graph.Matrix[from][to] == INF)
+                    {
+                        continue;
+                    }
+
+                    if (_shortestPath[to] > _shortestPath[from] + graph.Matrix[from][to])
+                    {
+                        _shortestPath[to] = _shortestPath[from] + graph.Matrix[from][to];
+                        _previousVertex[to] = from;
+                        updated = true;
+                    }
+                }
+            }
+
+            for (int last = 0; last < verticesNumber; last++)
+            {
+                if (last == home || _shortestPath[last] == INF || graph.Matrix[last][home] == INF)
+                {
+                    continue;
+                }
+
+                // Other negative cycles may break the chain of predecessors, so the cycle is taken only if the chain leads to home
+                // and its real weight is used rather than the distances.
+                vector<int> cycle = _PathFromRoot(home, last, onPath);
+                if (cycle.empty())
+                {
+                    continue;
+                }
+
+                double weight = CycleWeight(graph, cycle);
+                if (weight < bestWeight)
+                {
+                    bestWeight = weight;
+                    best = cycle;
+                }
+            }
+
+            if (!updated)
+                break;
+        }
+
+        _SearchCycleThrough(graph, home, maxExpansions, best, bestWeight);
+
+        _solved = true;
+
+        return best;
+    }
+
+    /// <summary>
+    /// Sum of edge weights along the cycle (including the closing edge from the last vertex back to the first one).
+    /// </summary>
+    static double CycleWeight(const Graph& graph, const vector<int>& cycle)
+    {
+        double weight = 0;
+        for (size_t i = 0; i < cycle.size(); i++)
+        {
+            weight += graph.Matrix[cycle[i]][cycle[(i + 1) % cycle.size()]];
+        }
+        return weight;
+    }
+
+    /// <summary>
+    /// Potentials for reweighting (Johnson): distances from a virtual source connected to every vertex with 0 weight edges,
+    /// so that every reduced cost w + p[from] - p[to] is non-negative.
+    /// Returns false if the graph contains a negative cycle (no potentials exist).
+    /// </summary>
+    static bool FindPotentials(const Graph& graph, vector<double>& potential)
+    {
+        int verticesNumber = graph.Matrix.size();
+        potential.assign(verticesNumber, 0.0);
+        for (int k = 0; k <= verticesNumber; k++)
+        {
+            bool updated = false;
+            for (int from = 0; from < verticesNumber; from++)
+            {
+                for (int to = 0; to < verticesNumber; to++)
+                {
+                    if (graph.Matrix[from][to] == INF) // Edge not exists
+                    {
+                        continue;
+                    }
+
+                    if (potential[to] > potential[from] + graph.Matrix[from][to])
+                    {
+                        potential[to] = potential[from] + graph.Matrix[from][to];
+                        updated = true;
+                    }
+                }
+            }
+
+            if (!updated)
+            {
+                return true;
+            }
+        }
+
+        return false; // Still improving after V + 1 passes: negative cycle.
+    }
+
+    vector<int> ReconstructShortestPath(Graph& graph, int start, int finish)
+    {
+        if (_solved)
+        {
+            list<int> list;
+            if (_shortestPath[finish] == NEG_INF)
+            {
+                cout << "Path from " << start << " to " << finish << " is : Infinite number of shortest paths (negative cycle)." << endl;
+                return {};
+            }
+
+            for (int at = finish; _previousVertex[at] != -1 && _previousVertex[at] != -2; at = _previousVertex[at])
+            {
+                list.push_back(at);
+            }
+            list.push_back(start);
+
+            std::vector<int> path(list.begin(), list.end());
+            reverse(path.begin(), path.end());
+
+            cout << "Path from " << start << " to " << finish << " is : ";
+            for (int i = 0; i < path.size(); i++)
+            {
+                cout << path[i] << "(" << graph.Nodes[path[i]].Name << ") ";
+            }
+            cout << endl;
+
+            return path;
+        }
+        else
+        {
+            cout << "Not solved." << endl;
+        }
+
+        return {};
+    }
+
+protected:
+    VertexQueue _queue; // FindPathOnly, and label-correcting solvers built on this class.
+
+private:
+    /// <summary>
+    /// Cheapest walk back to home with at most r hops which does not pass through home, for every vertex and r = 0..V - 1,
+    /// as layers of one flat array (walk from v with r hops is at [r * V + v]). Walks include all simple paths, so these are
+    /// lower bounds for the rest of a cycle. Layers stop changing when no negative cycle avoiding home is left to go around.
+    /// </summary>
+    vector<double> _WalksToHome(const Graph& graph, int home) const
+    {
+        int verticesNumber = graph.Matrix.size();
+        vector<double> walks(verticesNumber, INF);
+        walks[home] = 0;
+
+        for (int r = 1; r < verticesNumber; r++)
+        {
+            walks.insert(walks.end(), walks.end() - verticesNumber, walks.end()); // Fewer hops are allowed.
+            const double* current = walks.data() + (size_t)(r - 1) * verticesNumber;
+            double* next = walks.data() + (size_t)r * verticesNumber;
+
+            bool changed = false;
+            for (int from = 0; from < verticesNumber; from++)
+            {
+                if (from == home) // Walks end at home.
+                {
+                    continue;
+                }
+
+                for (int to = 0; to < verticesNumber; to++)
+                {
+                    if (graph.Matrix[from][to] != INF && current[to] < INF / 2 && next[from] > graph.Matrix[from][to] + current[to])
+                    {
+                        next[from] = graph.Matrix[from][to] + current[to];
+                        changed = true;
+                    }
+                }
+            }
+
+            if (!changed)
+            {
+                walks.resize((size_t)r * verticesNumber); // Same as the previous layer.
+                break;
+            }
+        }
+
+        return walks;
+    }
+
+    /// <summary>
+    /// Depth-first search over simple paths from home (with an explicit stack), closing them into cycles by edges into home.
+    /// A path is extended only if its weight plus the cheapest walk back to home with the hops left can beat bestWeight.
+    /// </summary>
+    void _SearchCycleThrough(const Graph& graph, int home, size_t maxExpansions, vector<int>& best, double& bestWeight) const
+    {
+        int verticesNumber = graph.Matrix.size();
+        vector<double> walks = _WalksToHome(graph, home);
+        int layers = (int)(walks.size() / verticesNumber);
+
+        vector<int> path = { home };
+        vector<int> nextTo = { 0 };     // Per path vertex: next out-edge to try.
+        vector<double> weight = { 0 };  // Per path vertex: weight of the path up to it.
+        vector<char> onPath(verticesNumber, 0);
+        onPath[home] = 1;
+
+        size_t expansions = 0;
+        while (!path.empty() && expansions < maxExpansions)
+        {
+            int from = path.back();
+            if (nextTo.back() == verticesNumber)
+            {
+                onPath[from] = 0;
+                path.pop_back();
+                nextTo.pop_back();
+                weight.pop_back();
+                continue;
+            }
+
+            int to = nextTo.back()++;
+            if (graph.Matrix[from][to] == INF) // Edge not exists
+            {
+                continue;
+            }
+
+            double reached = weight.back() + graph.Matrix[from][to];
+            if (to == home)
+            {
+                if (reached < bestWeight)
+                {
+                    bestWeight = reached;
+                    best = path;
+                }
+                continue;
+            }
+
+            // A simple cycle has at most V edges: after this one, V - |path| are left to get back.
+            int hopsLeft = min(verticesNumber - (int)path.size(), layers - 1);
+            if (onPath[to] || hopsLeft < 1 || reached + walks[(size_t)hopsLeft * verticesNumber + to] >= bestWeight)
+            {
+                continue;
+            }
+
+            expansions++;
+            onPath[to] = 1;
+            path.push_back(to);
+            nextTo.push_back(0);
+            weight.push_back(reached);
+        }
+    }
+
+    /// <summary>
+    /// Simple path root -> ... -> last by _previousVertex, or empty vector if the chain does not reach root without repeating a vertex.
+    /// onPath must be all zeros and is left all zeros.
+    /// </summary>
+    vector<int> _PathFromRoot(int root, int last, vector<char>& onPath)
+    {
+        vector<int> path;
+        int at = last;
+        while (at >= 0 && at != root && !onPath[at])
+        {
+            onPath[at] = 1;
+            path.push_back(at);
+            at = _previousVertex[at];
+        }
+
+        for (int v : path)
+        {
+            onPath[v] = 0;
+        }
+
+        if (at != root)
+        {
+            return {};
+        }
+
+        path.push_back(root);
+        reverse(path.begin(), path.end());
+        return path;
+    }
+};
+
+#endif
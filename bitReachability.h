@@ -0,0 +1,112 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Bit_Reachability_H
+#define Bit_Reachability_H
+
+#include <cstdint>
+#include "pathFindingBase.h"
+
+/// <summary>
+/// Reachability over the adjacency matrix kept as bitsets: one row of V bits per vertex, 64 targets per word.
+/// Visiting a vertex ORs its whole row into the reached set (word by word, which compilers vectorize) instead of testing
+/// V matrix cells, so a search over a dense graph costs V * V / 64 word operations.
+/// </summary>
+class BitReachability
+{
+public:
+    /// <summary>
+    /// Builds the bitset rows from the existing (non INF) edges.
+    /// </summary>
+    void Build(const Graph& graph)
+    {
+        _verticesNumber = graph.Matrix.size();
+        _words = (_verticesNumber + 63) / 64;
+        _rows.assign((size_t)_verticesNumber * _words, 0);
+        for (int from = 0; from < _verticesNumber; from++)
+        {
+            uint64_t* row = _Row(from);
+            for (int to = 0; to < _verticesNumber; to++)
+            {
+                if (graph.Matrix[from][to] != INF)
+                {
+                    row[to / 64] |= (uint64_t)1 << (to % 64);
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Marks (with 1) the sources and every vertex reachable from them.
+    /// </summary>
+    vector<char> From(const vector<int>& sources) const
+    {
+        vector<uint64_t> reached(_words, 0);
+        vector<int> queue;
+        queue.reserve(_verticesNumber);
+        for (int v : sources)
+        {
+            uint64_t bit = (uint64_t)1 << (v % 64);
+            if (!(reached[v / 64] & bit))
+            {
+                reached[v / 64] |= bit;
+                queue.push_back(v);
+            }
+        }
+
+        vector<uint64_t> fresh(_words);
+        for (size_t i = 0; i < queue.size(); i++)
+        {
+            const uint64_t* row = _Row(queue[i]);
+            for (int w = 0; w < _words; w++)
+            {
+                fresh[w] = row[w] & ~reached[w];
+                reached[w] |= fresh[w];
+            }
+
+            for (int w = 0; w < _words; w++)
+            {
+                for (uint64_t bits = fresh[w]; bits != 0; bits &= bits - 1)
+                {
+                    queue.push_back(w * 64 + _LowestBit(bits));
+                }
+            }
+        }
+
+        vector<char> result(_verticesNumber, 0);
+        for (int v : queue)
+        {
+            result[v] = 1;
+        }
+        return result;
+    }
+
+private:
+    int _verticesNumber = 0;
+    int _words = 0;
+    vector<uint64_t> _rows;
+
+    uint64_t* _Row(int v)
+    {
+        return _rows.data() + (size_t)v * _words;
+    }
+
+    const uint64_t* _Row(int v) const
+    {
+        return _rows.data() + (size_t)v * _words;
+    }
+
+    static int _LowestBit(uint64_t bits)
+    {
+        int index = 0;
+        while (!(bits & 1))
+        {
+            bits >>= 1;
+            index++;
+        }
+        return index;
+    }
+};
+
+#endif
@@ -0,0 +1,197 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Circuit_Enumerator_H
+#define Circuit_Enumerator_H
+
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include "pathFindingBase.h"
+
+/// <summary>
+/// Elementary circuit (simple cycle) with its total weight, starting from its smallest vertex.
+/// </summary>
+struct Circuit
+{
+    vector<int> Cycle;
+    double Weight;
+};
+
+/// <summary>
+/// Enumerates all elementary circuits with at most maxLength edges and weight below maxWeight (all executable loops up to
+/// length L, not just one negative cycle). Diagonal of Graph::Matrix is ignored.
+///
+/// As in Johnson's algorithm every circuit is found once, from its smallest vertex s, by a search restricted to vertices >= s.
+/// Johnson's blocking does not hold with a length bound, so the search is pruned by hop limited Bellman-Ford bounds instead:
+/// for every k, the lightest walk from v back to s with at most k edges (it exists even with negative cycles). A branch is cut
+/// when its weight plus the bound for the remaining edges can not get below maxWeight; this also cuts vertices which can not
+/// reach s within the remaining length.
+/// Start vertices are handed out to threads one by one from a shared counter, so threads that finish early take the remaining
+/// work, and each thread collects circuits in its own buffer; buffers are merged and sorted by weight at the end.
+/// </summary>
+class CircuitEnumerator
+{
+public:
+    CircuitEnumerator(int threadsNumber = 0)
+        : _threadsNumber(threadsNumber > 0 ? threadsNumber : max(1, (int)thread::hardware_concurrency()))
+    {
+    }
+
+    vector<Circuit> Enumerate(const Graph& graph, int maxLength, double maxWeight = 0)
+    {
+        int verticesNumber = graph.Matrix.size();
+        atomic<int> nextStart(0);
+        int threadsNumber = max(1, min(_threadsNumber, verticesNumber));
+        vector<vector<Circuit>> buffers(threadsNumber);
+
+        vector<thread> threads;
+        threads.reserve(threadsNumber);
+        for (int t = 0; t < threadsNumber; t++)
+        {
+            threads.emplace_back([&graph, &nextStart, &buffers, t, maxLength, maxWeight, verticesNumber]()
+            {
+                StartSearch search(graph, maxLength, maxWeight, buffers[t]);
+                for (int start = nextStart++; start < verticesNumber; start = nextStart++)
+                {
+                    search.Run(start);
+                }
+            });
+        }
+        for (thread& worker : threads)
+        {
+            worker.join();
+        }
+
+        vector<Circuit> circuits;
+        for (vector<Circuit>& buffer : buffers)
+        {
+            circuits.insert(circuits.end(), buffer.begin(), buffer.end());
+        }
+        sort(circuits.begin(), circuits.end(), [](const Circuit& a, const Circuit& b)
+        {
+            return a.Weight != b.Weight ? a.Weight < b.Weight : a.Cycle < b.Cycle;
+        });
+
+        return circuits;
+    }
+
+private:
+    int _threadsNumber;
+
+    /// <summary>
+    /// Per thread state: depth first search from one start vertex at a time.
+    /// </summary>
+    class StartSearch
+    {
+    public:
+        StartSearch(const Graph& graph, int maxLength, double maxWeight, vector<Circuit>& output)
+            : _graph(graph),
+              _verticesNumber(graph.Matrix.size()),
+              _maxLength(maxLength),
+              _maxWeight(maxWeight),
+              _output(output),
+              _onPath(graph.Matrix.size(), 0),
+              _bound((size_t)(maxLength + 1) * graph.Matrix.size())
+        {
+        }
+
+        void Run(int start)
+        {
+            _start = start;
+            _ComputeBounds();
+            _path.assign(1, start);
+            _onPath[start] = 1;
+            _Extend(start, 0.0);
+            _onPath[start] = 0;
+        }
+
+    private:
+        // Bound and circuit weights are summed in different order: cut only clearly hopeless branches.
+        static constexpr double EPSILON = 1e-9;
+
+        const Graph& _graph;
+        int _verticesNumber;
+        int _maxLength;
+        double _maxWeight;
+        vector<Circuit>& _output;
+        vector<char> _onPath;
+        vector<double> _bound; // _bound[k * V + v]: lightest walk v -> start with at most k edges over vertices >= start.
+        vector<int> _path;
+        int _start = 0;
+
+        double _Bound(int edges, int v) const
+        {
+            return _bound[(size_t)edges * _verticesNumber + v];
+        }
+
+        bool _IsEdge(int from, int to) const
+        {
+            return from != to && _graph.Matrix[from][to] != INF;
+        }
+
+        void _ComputeBounds()
+        {
+            fill(_bound.begin(), _bound.begin() + _verticesNumber, INF);
+            _bound[_start] = 0;
+            for (int k = 1; k <= _maxLength; k++)
+            {
+                const double* previous = _bound.data() + (size_t)(k - 1) * _verticesNumber;
+                double* current = _bound.data() + (size_t)k * _verticesNumber;
+                copy(previous, previous + _verticesNumber, current);
+                for (int v = _start; v < _verticesNumber; v++)
+                {
+                    for (int to = _start; to < _verticesNumber; to++)
+                    {
+                        if (_IsEdge(v, to) && previous[to] != INF && _graph.Matrix[v][to] + previous[to] < current[v])
+                        {
+                            current[v] = _graph.Matrix[v][to] + previous[to];
+                        }
+                    }
+                }
+            }
+        }
+
+        void _Extend(int at, double weight)
+        {
+            int edges = _path.size(); // Edges after taking the next one.
+            for (int to = _start; to < _verticesNumber; to++)
+            {
+                if (!_IsEdge(at, to))
+                {
+                    continue;
+                }
+
+                double next = weight + _graph.Matrix[at][to];
+                if (to == _start)
+                {
+                    if (next < _maxWeight)
+                    {
+                        _output.push_back({ _path, next });
+                    }
+                    continue;
+                }
+
+                // The way back from `to` has at most maxLength - edges edges.
+                if (_onPath[to] || edges >= _maxLength)
+                {
+                    continue;
+                }
+                double back = _Bound(_maxLength - edges, to);
+                if (back == INF || next + back >= _maxWeight + EPSILON)
+                {
+                    continue;
+                }
+
+                _path.push_back(to);
+                _onPath[to] = 1;
+                _Extend(to, next);
+                _onPath[to] = 0;
+                _path.pop_back();
+            }
+        }
+    };
+};
+
+#endif
@@ -0,0 +1,175 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Constrained_Path_Finder_H
+#define Constrained_Path_Finder_H
+
+#include <iostream>
+#include <queue>
+#include <algorithm>
+#include "pathFindingBase.h"
+
+/// <summary>
+/// Resource constrained shortest path: the cheapest conversion path from start to finish (by Graph::Matrix) whose total
+/// latency (by Graph::Latency, one unit per leg if it is empty) stays within the budget.
+///
+/// Label setting algorithm: a label is a partial path (cost, latency) ending at a vertex. Labels are expanded in increasing
+/// latency order and a label is dropped if another label at the same vertex is not worse in both cost and latency.
+/// Latencies must be positive, which also bounds paths going around negative cycles.
+/// Labels live in one pool (vector reused between queries) and refer to their parent by index, so no per-label allocations.
+/// </summary>
+class ConstrainedPathFinder
+{
+public:
+    double _bestCost = INF;
+    double _bestLatency = INF;
+
+    /// <summary>
+    /// Returns the path (start ... finish) and prints it like BellmanFordAlgorithm::ReconstructShortestPath, or empty vector if there is no path within the budget.
+    /// </summary>
+    vector<int> FindPath(Graph& graph, int start, int finish, double latencyBudget)
+    {
+        int verticesNumber = graph.Nodes.size();
+
+        for (int from = 0; from < (int)graph.Latency.size(); from++)
+        {
+            for (int to = 0; to < verticesNumber; to++)
+            {
+                if (from != to && graph.Matrix[from][to] != INF && graph.Latency[from][to] <= 0)
+                {
+                    cout << "Latency of edge " << from << "->" << to << " must be positive." << endl;
+                    return {};
+                }
+            }
+        }
+
+        _pool.clear();
+        _labelsAt.assign(verticesNumber, {});
+        _bestCost = INF;
+        _bestLatency = INF;
+        int bestLabel = -1;
+
+        priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> queue;
+        _pool.push_back({ 0.0, 0.0, start, -1, false });
+        _labelsAt[start].push_back(0);
+        queue.push({ 0.0, 0 });
+
+        while (!queue.empty())
+        {
+            int index = queue.top().second;
+            queue.pop();
+
+            if (_pool[index].Dominated)
+            {
+                continue;
+            }
+
+            Label label = _pool[index]; // Copy: the pool may grow below.
+            if (label.Vertex == finish && label.Cost < _bestCost)
+            {
+                _bestCost = label.Cost;
+                _bestLatency = label.Latency;
+                bestLabel = index;
+            }
+
+            for (int to = 0; to < verticesNumber; to++)
+            {
+                if (to == label.Vertex || graph.Matrix[label.Vertex][to] == INF) // Edge not exists
+                {
+                    continue;
+                }
+
+                double latency = label.Latency + _Latency(graph, label.Vertex, to);
+                if (latency > latencyBudget)
+                {
+                    continue;
+                }
+
+                double cost = label.Cost + graph.Matrix[label.Vertex][to];
+                if (_AddIfNotDominated(to, cost, latency, index))
+                {
+                    queue.push({ latency, (int)_pool.size() - 1 });
+                }
+            }
+        }
+
+        if (bestLabel == -1)
+        {
+            cout << "Path from " << start << " to " << finish << " is : Not reachable within latency " << latencyBudget << "." << endl;
+            return {};
+        }
+
+        vector<int> path;
+        for (int at = bestLabel; at != -1; at = _pool[at].Parent)
+        {
+            path.push_back(_pool[at].Vertex);
+        }
+        reverse(path.begin(), path.end());
+
+        cout << "Path from " << start << " to " << finish << " within latency " << latencyBudget << " is : ";
+        for (int i = 0; i < (int)path.size(); i++)
+        {
+            cout << path[i] << "(" << graph.Nodes[path[i]].Name << ") ";
+        }
+        cout << "cost " << _bestCost << ", latency " << _bestLatency << endl;
+
+        return path;
+    }
+
+    size_t LabelsCreated() const
+    {
+        return _pool.size();
+    }
+
+private:
+    struct Label
+    {
+        double Cost;
+        double Latency;
+        int Vertex;
+        int Parent; // Index in _pool, -1 for the start label.
+        bool Dominated;
+    };
+
+    vector<Label> _pool;
+    vector<vector<int>> _labelsAt; // Indexes of not dominated labels per vertex.
+
+    double _Latency(const Graph& graph, int from, int to) const
+    {
+        return graph.Latency.empty() ? 1.0 : graph.Latency[from][to];
+    }
+
+    bool _AddIfNotDominated(int vertex, double cost, double latency, int parent)
+    {
+        vector<int>& labels = _labelsAt[vertex];
+        for (int index : labels)
+        {
+            if (_pool[index].Cost <= cost && _pool[index].Latency <= latency)
+            {
+                return false;
+            }
+        }
+
+        // New label removes the ones it dominates.
+        size_t kept = 0;
+        for (int index : labels)
+        {
+            if (cost <= _pool[index].Cost && latency <= _pool[index].Latency)
+            {
+                _pool[index].Dominated = true;
+            }
+            else
+            {
+                labels[kept++] = index;
+            }
+        }
+        labels.resize(kept);
+
+        _pool.push_back({ cost, latency, vertex, parent, false });
+        labels.push_back(_pool.size() - 1);
+        return true;
+    }
+};
+
+#endif
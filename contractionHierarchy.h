@@ -0,0 +1,463 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Contraction_Hierarchy_H
+#define Contraction_Hierarchy_H
+
+#include <iostream>
+#include <queue>
+#include <thread>
+#include <limits>
+#include <algorithm>
+#include "pathFindingBase.h"
+#include "bellmanFordAlgorithm.h"
+
+/// <summary>
+/// Customizable contraction hierarchy for many point-to-point queries on one graph topology.
+///
+/// Built in two phases:
+/// - Build (once per topology): vertices are ordered by minimum degree elimination on the undirected edge set and every vertex is
+///   contracted by connecting all its higher ranked neighbors. This gives the hierarchy arcs (lower vertex -> higher vertex) without
+///   looking at weights. Potentials from BellmanFordAlgorithm::FindPotentials are computed here too.
+/// - Customize (once per tick): arc weights in both directions are set to the reduced costs of the current Graph::Matrix and
+///   shortcuts are updated through lower triangles. A vertex writes only its own upward arcs and reads arcs of lower vertices,
+///   so all vertices of one level of the elimination order are customized in parallel.
+/// A query is an upward search from start and an upward search from finish on reversed arcs; the best meeting vertex gives the path.
+/// Searches only go up the hierarchy, so vertices are settled in rank order and weights may even be negative (reduced costs
+/// of a tick after the last Build); while they are all non-negative the backward search is also pruned by the best path found.
+///
+/// Only weights may change between Build and Customize: an edge turning to INF is fine, a new edge needs a new Build.
+/// </summary>
+class ContractionHierarchy
+{
+public:
+    double _pathCost = INF;
+    int _settled = 0; // Vertices settled by the last query, both directions.
+
+    ContractionHierarchy(int threadsNumber = 0)
+        : _threadsNumber(threadsNumber > 0 ? threadsNumber : max(1, (int)thread::hardware_concurrency()))
+    {
+    }
+
+    /// <summary>
+    /// Orders and contracts the graph, then customizes it. Returns false if the graph contains a negative cycle.
+    /// </summary>
+    bool Build(const Graph& graph)
+    {
+        _verticesNumber = graph.Matrix.size();
+        if (!BellmanFordAlgorithm::FindPotentials(graph, _potential))
+        {
+            return false;
+        }
+
+        _Contract(graph);
+
+        _forwardDistance.assign(_verticesNumber, UNREACHED);
+        _backwardDistance.assign(_verticesNumber, UNREACHED);
+        _forwardParent.assign(_verticesNumber, -1);
+        _backwardParent.assign(_verticesNumber, -1);
+
+        return Customize(graph);
+    }
+
+    /// <summary>
+    /// Recomputes arc weights from the current weights of the graph, keeping the order and arcs of the last Build.
+    /// Returns false if the new weights contain a negative cycle (then queries are meaningless until the next successful Customize).
+    /// </summary>
+    bool Customize(const Graph& graph)
+    {
+        _nonNegative = true;
+        for (size_t arc = 0; arc < _arcTail.size(); arc++)
+        {
+            _upCost[arc] = _ReducedCost(graph, _arcTail[arc], _arcHead[arc]);
+            _downCost[arc] = _ReducedCost(graph, _arcHead[arc], _arcTail[arc]);
+            _upVia[arc] = -1;
+            _downVia[arc] = -1;
+        }
+
+        for (const vector<int>& level : _levels)
+        {
+            int threadsNumber = min(_threadsNumber, (int)level.size());
+            if (threadsNumber <= 1)
+            {
+                for (int v : level)
+                {
+                    _CustomizeVertex(v);
+                }
+                continue;
+            }
+
+            vector<thread> threads;
+            threads.reserve(threadsNumber);
+            for (int t = 0; t < threadsNumber; t++)
+            {
+                threads.emplace_back([this, &level, t, threadsNumber]()
+                {
+                    for (size_t i = t; i < level.size(); i += threadsNumber)
+                    {
+                        _CustomizeVertex(level[i]);
+                    }
+                });
+            }
+            for (thread& worker : threads)
+            {
+                worker.join();
+            }
+        }
+
+        bool negativeCycle = false;
+        for (size_t arc = 0; arc < _arcTail.size(); arc++)
+        {
+            // Any negative cycle ends up as a negative 2-cycle between its two highest ranked vertices.
+            if (_upCost[arc] != UNREACHED && _downCost[arc] != UNREACHED && _upCost[arc] + _downCost[arc] < -1e-9)
+            {
+                negativeCycle = true;
+            }
+            if (_upCost[arc] < 0 || _downCost[arc] < 0)
+            {
+                _nonNegative = false;
+            }
+        }
+
+        return !negativeCycle;
+    }
+
+    /// <summary>
+    /// Cost of the best path start -> finish, or INF if not reachable. Does not print nor unpack the path.
+    /// </summary>
+    double Query(int start, int finish)
+    {
+        int meet = _Search(start, finish);
+        double cost = meet == -1 ? INF : _forwardDistance[meet] + _backwardDistance[meet] - _potential[start] + _potential[finish];
+        _Reset();
+        return cost;
+    }
+
+    /// <summary>
+    /// Returns path start ... finish with shortcuts unpacked and prints it like BellmanFordAlgorithm::ReconstructShortestPath.
+    /// </summary>
+    vector<int> FindPath(Graph& graph, int start, int finish)
+    {
+        _pathCost = INF;
+        int meet = _Search(start, finish);
+        if (meet == -1)
+        {
+            _Reset();
+            cout << "Path from " << start << " to " << finish << " is : Not reachable." << endl;
+            return {};
+        }
+
+        _pathCost = _forwardDistance[meet] + _backwardDistance[meet] - _potential[start] + _potential[finish];
+
+        // Hierarchy path: start ... meet by forward parents, then meet ... finish by backward parents.
+        vector<int> hierarchyPath;
+        for (int at = meet; at != -1; at = _forwardParent[at])
+        {
+            hierarchyPath.push_back(at);
+        }
+        reverse(hierarchyPath.begin(), hierarchyPath.end());
+        for (int at = _backwardParent[meet]; at != -1; at = _backwardParent[at])
+        {
+            hierarchyPath.push_back(at);
+        }
+        _Reset();
+
+        vector<int> path = { start };
+        for (size_t i = 0; i + 1 < hierarchyPath.size(); i++)
+        {
+            _Unpack(hierarchyPath[i], hierarchyPath[i + 1], path);
+        }
+
+        cout << "Path from " << start << " to " << finish << " is : ";
+        for (int i = 0; i < (int)path.size(); i++)
+        {
+            cout << path[i] << "(" << graph.Nodes[path[i]].Name << ") ";
+        }
+        cout << endl;
+
+        return path;
+    }
+
+    size_t ArcsNumber() const
+    {
+        return _arcTail.size();
+    }
+
+    size_t LevelsNumber() const
+    {
+        return _levels.size();
+    }
+
+private:
+    static constexpr double UNREACHED = numeric_limits<double>::infinity();
+
+    int _threadsNumber;
+    int _verticesNumber = 0;
+    bool _nonNegative = true;
+    vector<double> _potential;
+
+    vector<int> _rank;
+    vector<int> _arcIndex;           // V x V, arc between two vertices (in any direction) or -1.
+    vector<int> _arcTail;            // Lower ranked end of the arc.
+    vector<int> _arcHead;            // Higher ranked end of the arc.
+    vector<vector<int>> _upArcs;     // Arcs whose tail is the vertex.
+    vector<vector<int>> _lowerNeighbors;
+    vector<vector<int>> _levels;     // Vertices of each level; a vertex level is above levels of all its lower neighbors.
+
+    vector<double> _upCost;          // Reduced cost tail -> head.
+    vector<double> _downCost;        // Reduced cost head -> tail.
+    vector<int> _upVia;              // Middle vertex of the shortcut tail -> head, -1 for an original edge.
+    vector<int> _downVia;
+
+    vector<double> _forwardDistance; // Query buffers, kept at UNREACHED / -1 between queries.
+    vector<double> _backwardDistance;
+    vector<int> _forwardParent;
+    vector<int> _backwardParent;
+    vector<int> _touched;
+
+    double _ReducedCost(const Graph& graph, int from, int to) const
+    {
+        if (graph.Matrix[from][to] == INF) // Edge not exists
+        {
+            return UNREACHED;
+        }
+        return graph.Matrix[from][to] + _potential[from] - _potential[to];
+    }
+
+    int _Arc(int a, int b) const
+    {
+        return _arcIndex[(size_t)a * _verticesNumber + b];
+    }
+
+    /// <summary>
+    /// Minimum degree elimination: contracts the vertex with fewest remaining neighbors, connecting the neighbors pairwise.
+    /// </summary>
+    void _Contract(const Graph& graph)
+    {
+        int n = _verticesNumber;
+        vector<char> adjacent((size_t)n * n, 0);
+        vector<int> degree(n, 0);
+        for (int from = 0; from < n; from++)
+        {
+            for (int to = from + 1; to < n; to++)
+            {
+                if (graph.Matrix[from][to] != INF || graph.Matrix[to][from] != INF)
+                {
+                    adjacent[(size_t)from * n + to] = adjacent[(size_t)to * n + from] = 1;
+                    degree[from]++;
+                    degree[to]++;
+                }
+            }
+        }
+
+        _rank.assign(n, -1);
+        _arcIndex.assign((size_t)n * n, -1);
+        _arcTail.clear();
+        _arcHead.clear();
+        _upArcs.assign(n, {});
+        _lowerNeighbors.assign(n, {});
+
+        for (int r = 0; r < n; r++)
+        {
+            int v = -1;
+            for (int candidate = 0; candidate < n; candidate++)
+            {
+                if (_rank[candidate] == -1 && (v == -1 || degree[candidate] < degree[v]))
+                {
+                    v = candidate;
+                }
+            }
+            _rank[v] = r;
+
+            vector<int> neighbors;
+            for (int other = 0; other < n; other++)
+            {
+                if (_rank[other] == -1 && adjacent[(size_t)v * n + other])
+                {
+                    neighbors.push_back(other);
+                    degree[other]--;
+                }
+            }
+
+            for (size_t i = 0; i < neighbors.size(); i++)
+            {
+                int arc = _arcTail.size();
+                _arcTail.push_back(v);
+                _arcHead.push_back(neighbors[i]);
+                _arcIndex[(size_t)v * n + neighbors[i]] = _arcIndex[(size_t)neighbors[i] * n + v] = arc;
+                _upArcs[v].push_back(arc);
+                _lowerNeighbors[neighbors[i]].push_back(v);
+
+                for (size_t j = i + 1; j < neighbors.size(); j++)
+                {
+                    char& edge = adjacent[(size_t)neighbors[i] * n + neighbors[j]];
+                    if (!edge)
+                    {
+                        edge = adjacent[(size_t)neighbors[j] * n + neighbors[i]] = 1;
+                        degree[neighbors[i]]++;
+                        degree[neighbors[j]]++;
+                    }
+                }
+            }
+        }
+
+        vector<int> order(n);
+        for (int v = 0; v < n; v++)
+        {
+            order[_rank[v]] = v;
+        }
+
+        vector<int> level(n, 0);
+        _levels.clear();
+        for (int v : order)
+        {
+            for (int lower : _lowerNeighbors[v])
+            {
+                level[v] = max(level[v], level[lower] + 1);
+            }
+            if (level[v] >= (int)_levels.size())
+            {
+                _levels.resize(level[v] + 1);
+            }
+            _levels[level[v]].push_back(v);
+        }
+
+        _upCost.assign(_arcTail.size(), UNREACHED);
+        _downCost.assign(_arcTail.size(), UNREACHED);
+        _upVia.assign(_arcTail.size(), -1);
+        _downVia.assign(_arcTail.size(), -1);
+    }
+
+    /// <summary>
+    /// Updates upward arcs v -> w by lower triangles v - u - w. Arcs of u are final: u is on a lower level.
+    /// </summary>
+    void _CustomizeVertex(int v)
+    {
+        for (int arc : _upArcs[v])
+        {
+            int w = _arcHead[arc];
+            for (int u : _lowerNeighbors[v])
+            {
+                int toW = _Arc(u, w);
+                if (toW == -1)
+                {
+                    continue;
+                }
+                int toV = _Arc(u, v);
+
+                double up = _downCost[toV] + _upCost[toW];   // v -> u -> w
+                if (up < _upCost[arc])
+                {
+                    _upCost[arc] = up;
+                    _upVia[arc] = u;
+                }
+
+                double down = _downCost[toW] + _upCost[toV]; // w -> u -> v
+                if (down < _downCost[arc])
+                {
+                    _downCost[arc] = down;
+                    _downVia[arc] = u;
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Upward search from the source, in rank order. Backward search uses costs head -> tail and updates the best meeting vertex.
+    /// </summary>
+    void _Upward(int source, bool backward, int& meet, double& best)
+    {
+        vector<double>& distance = backward ? _backwardDistance : _forwardDistance;
+        vector<int>& parent = backward ? _backwardParent : _forwardParent;
+
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> queue; // (rank, vertex)
+        distance[source] = 0;
+        _touched.push_back(source);
+        queue.push({ _rank[source], source });
+
+        while (!queue.empty())
+        {
+            int at = queue.top().second;
+            queue.pop();
+            _settled++;
+
+            if (backward && _forwardDistance[at] != UNREACHED && _forwardDistance[at] + distance[at] < best)
+            {
+                best = _forwardDistance[at] + distance[at];
+                meet = at;
+            }
+            if (_nonNegative && distance[at] >= best) // Every continuation is at least as expensive.
+            {
+                continue;
+            }
+
+            for (int arc : _upArcs[at])
+            {
+                double cost = backward ? _downCost[arc] : _upCost[arc];
+                if (cost == UNREACHED)
+                {
+                    continue;
+                }
+
+                int to = _arcHead[arc];
+                if (_forwardDistance[to] == UNREACHED && _backwardDistance[to] == UNREACHED)
+                {
+                    _touched.push_back(to);
+                }
+                if (distance[to] == UNREACHED)
+                {
+                    queue.push({ _rank[to], to });
+                }
+                if (distance[at] + cost < distance[to])
+                {
+                    distance[to] = distance[at] + cost;
+                    parent[to] = at;
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Returns the meeting vertex of the best path or -1. Buffers stay filled until _Reset.
+    /// </summary>
+    int _Search(int start, int finish)
+    {
+        _settled = 0;
+        int meet = -1;
+        double best = UNREACHED;
+        _Upward(start, false, meet, best);
+        _Upward(finish, true, meet, best);
+        return meet;
+    }
+
+    void _Reset()
+    {
+        for (int v : _touched)
+        {
+            _forwardDistance[v] = UNREACHED;
+            _backwardDistance[v] = UNREACHED;
+            _forwardParent[v] = -1;
+            _backwardParent[v] = -1;
+        }
+        _touched.clear();
+    }
+
+    /// <summary>
+    /// Appends the original vertices of the hierarchy edge from -> to (without from itself).
+    /// </summary>
+    void _Unpack(int from, int to, vector<int>& path) const
+    {
+        int arc = _Arc(from, to);
+        int via = _arcTail[arc] == from ? _upVia[arc] : _downVia[arc];
+        if (via == -1)
+        {
+            path.push_back(to);
+            return;
+        }
+        _Unpack(from, via, path);
+        _Unpack(via, to, path);
+    }
+};
+
+#endif
@@ -0,0 +1,106 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Cycle_Pruning_H
+#define Cycle_Pruning_H
+
+#include "pathFindingBase.h"
+
+/// <summary>
+/// Marks vertices which can not lie on any cycle: a vertex without incoming or without outgoing edges (among the vertices still
+/// active) is dropped, which may leave its neighbors without edges too, and so on. What stays is the part of the graph where all
+/// cycles are. The result is a mask over the original vertex indexes; the graph itself is not copied.
+///
+/// One pass over the matrix to count degrees and one scan of the row and the column of every dropped vertex: O(V^2),
+/// linear in the size of Graph::Matrix. The diagonal counts only when it is negative (a negative self-loop is a cycle).
+/// </summary>
+class CyclePruning
+{
+public:
+    vector<char> Active;
+    int ActiveNumber = 0;
+
+    /// <summary>
+    /// Prunes the graph, or only the vertices enabled in mask if it is not empty.
+    /// </summary>
+    void Compute(const Graph& graph, const vector<char>& mask = {})
+    {
+        int verticesNumber = graph.Matrix.size();
+        Active = mask.empty() ? vector<char>(verticesNumber, 1) : mask;
+
+        vector<int> inDegree(verticesNumber, 0);
+        vector<int> outDegree(verticesNumber, 0);
+        for (int from = 0; from < verticesNumber; from++)
+        {
+            if (!Active[from])
+            {
+                continue;
+            }
+
+            for (int to = 0; to < verticesNumber; to++)
+            {
+                if (Active[to] && _IsEdge(graph, from, to))
+                {
+                    outDegree[from]++;
+                    inDegree[to]++;
+                }
+            }
+        }
+
+        vector<int> dropped;
+        for (int v = 0; v < verticesNumber; v++)
+        {
+            if (Active[v] && (inDegree[v] == 0 || outDegree[v] == 0))
+            {
+                Active[v] = 0;
+                dropped.push_back(v);
+            }
+        }
+
+        // Every dropped vertex takes its edges with it; neighbors losing the last edge on one side are dropped next.
+        for (size_t i = 0; i < dropped.size(); i++)
+        {
+            int v = dropped[i];
+            for (int other = 0; other < verticesNumber; other++)
+            {
+                if (!Active[other])
+                {
+                    continue;
+                }
+
+                if (_IsEdge(graph, v, other))
+                {
+                    inDegree[other]--;
+                }
+                if (_IsEdge(graph, other, v))
+                {
+                    outDegree[other]--;
+                }
+                if (inDegree[other] == 0 || outDegree[other] == 0)
+                {
+                    Active[other] = 0;
+                    dropped.push_back(other);
+                }
+            }
+        }
+
+        ActiveNumber = 0;
+        for (int v = 0; v < verticesNumber; v++)
+        {
+            ActiveNumber += Active[v];
+        }
+    }
+
+private:
+    static bool _IsEdge(const Graph& graph, int from, int to)
+    {
+        if (from == to)
+        {
+            return graph.Matrix[from][to] < 0;
+        }
+        return graph.Matrix[from][to] != INF;
+    }
+};
+
+#endif
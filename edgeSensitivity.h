@@ -0,0 +1,181 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Edge_Sensitivity_H
+#define Edge_Sensitivity_H
+
+#include <limits>
+#include "pathFindingBase.h"
+#include "bellmanFordAlgorithm.h"
+
+/// <summary>
+/// Sensitivity ranges of edge weights for a solution without negative cycles: for every edge, the interval of weights
+/// over which the current shortest path tree stays optimal and no negative cycle appears (other edges unchanged).
+/// Updates falling inside the range can be dropped without touching the solver; the distance to the nearest bound (Slack)
+/// tells how close the market is to a new opportunity.
+///
+/// With reduced costs r(x, y) = w + d[x] - d[y] >= 0:
+/// - edge not on the tree: range is [d[y] - d[x], +inf), i.e. its reduced cost stays non-negative;
+/// - tree edge into v: decreasing it by delta lowers the whole subtree of v by delta, so delta is bounded by the smallest reduced cost
+///   of edges leaving the subtree; increasing it by delta is bounded by the smallest reduced cost of edges entering the subtree
+///   (an alternative parent would become better).
+/// Both minimums are collected in one scan of the edges, walking from the ends of every non tree edge up to their common ancestor.
+/// </summary>
+class EdgeSensitivity
+{
+public:
+    /// <summary>
+    /// Computes ranges from a solved BellmanFordAlgorithm. Returns false if there is no solution or it contains negative cycles.
+    /// </summary>
+    bool Compute(const Graph& graph, const BellmanFordAlgorithm& solution)
+    {
+        const vector<double>& distance = solution._shortestPath;
+        const vector<int>& parent = solution._previousVertex;
+        int verticesNumber = graph.Nodes.size();
+
+        _verticesNumber = 0;
+        if (!solution._solved || (int)distance.size() != verticesNumber)
+        {
+            return false;
+        }
+
+        vector<int> depth(verticesNumber, -1);
+        for (int v = 0; v < verticesNumber; v++)
+        {
+            if (distance[v] == NEG_INF)
+            {
+                return false;
+            }
+            _Depth(v, distance, parent, depth);
+        }
+
+        const double infinity = numeric_limits<double>::infinity();
+        _verticesNumber = verticesNumber;
+        _lower.assign(verticesNumber * verticesNumber, -infinity);
+        _upper.assign(verticesNumber * verticesNumber, infinity);
+
+        vector<double> minLeaving(verticesNumber, infinity);
+        vector<double> minEntering(verticesNumber, infinity);
+
+        for (int from = 0; from < verticesNumber; from++)
+        {
+            if (depth[from] == -1) // Not reachable: its out edges cannot change the solution.
+            {
+                continue;
+            }
+
+            for (int to = 0; to < verticesNumber; to++)
+            {
+                if (graph.Matrix[from][to] == INF || _IsTreeEdge(from, to, parent, depth))
+                {
+                    continue;
+                }
+
+                double reducedCost = graph.Matrix[from][to] + distance[from] - distance[to];
+                _lower[from * verticesNumber + to] = distance[to] - distance[from];
+
+                // Vertices on the tree path from "from" up to the common ancestor have this edge leaving their subtree,
+                // vertices on the path from "to" up to it have the edge entering their subtree.
+                int a = from;
+                int b = to;
+                while (depth[a] > depth[b])
+                {
+                    minLeaving[a] = min(minLeaving[a], reducedCost);
+                    a = parent[a];
+                }
+                while (depth[b] > depth[a])
+                {
+                    minEntering[b] = min(minEntering[b], reducedCost);
+                    b = parent[b];
+                }
+                while (a != b)
+                {
+                    minLeaving[a] = min(minLeaving[a], reducedCost);
+                    minEntering[b] = min(minEntering[b], reducedCost);
+                    a = parent[a];
+                    b = parent[b];
+                }
+            }
+        }
+
+        for (int v = 0; v < verticesNumber; v++)
+        {
+            if (depth[v] > 0)
+            {
+                int from = parent[v];
+                double weight = graph.Matrix[from][v];
+                _lower[from * verticesNumber + v] = weight - minLeaving[v];
+                _upper[from * verticesNumber + v] = weight + minEntering[v];
+            }
+        }
+
+        return true;
+    }
+
+    double Lower(int from, int to) const
+    {
+        return _lower[from * _verticesNumber + to];
+    }
+
+    double Upper(int from, int to) const
+    {
+        return _upper[from * _verticesNumber + to];
+    }
+
+    /// <summary>
+    /// True if the solution stays optimal with this (single) edge set to the given weight.
+    /// </summary>
+    bool Contains(int from, int to, double weight) const
+    {
+        return weight >= Lower(from, to) && weight <= Upper(from, to);
+    }
+
+    /// <summary>
+    /// How much the weight of the edge may still go down before a path improves or a negative cycle appears.
+    /// </summary>
+    double Slack(const Graph& graph, int from, int to) const
+    {
+        return graph.Matrix[from][to] - Lower(from, to);
+    }
+
+private:
+    int _verticesNumber = 0;
+    vector<double> _lower;
+    vector<double> _upper;
+
+    /// <summary>
+    /// Depth of v in the shortest path tree, -1 for vertices not reachable from start.
+    /// </summary>
+    int _Depth(int v, const vector<double>& distance, const vector<int>& parent, vector<int>& depth)
+    {
+        if (depth[v] != -1 || distance[v] >= INF / 2)
+        {
+            return depth[v];
+        }
+
+        // Walk up to the first vertex with known depth (or the root), then assign depths on the way back.
+        vector<int> chain;
+        int at = v;
+        while (depth[at] == -1 && parent[at] >= 0)
+        {
+            chain.push_back(at);
+            at = parent[at];
+        }
+
+        int base = depth[at] != -1 ? depth[at] : (depth[at] = 0);
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+        {
+            depth[*it] = ++base;
+        }
+
+        return depth[v];
+    }
+
+    bool _IsTreeEdge(int from, int to, const vector<int>& parent, const vector<int>& depth) const
+    {
+        return depth[to] > 0 && parent[to] == from;
+    }
+};
+
+#endif
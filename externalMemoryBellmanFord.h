@@ -0,0 +1,256 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef External_Memory_Bellman_Ford_H
+#define External_Memory_Bellman_Ford_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include "pathFindingBase.h"
+#include "bellmanFordAlgorithm.h"
+#include "compressedGraph.h"
+
+/// <summary>
+/// Out-of-core Bellman-Ford for graphs whose edges do not fit in memory.
+/// Edges live in a binary file grouped by From vertex, one row per vertex in vertex order: a varint number of edges, then for
+/// every edge its To vertex as a varint delta from the previous one (rows are sorted, as in CompressedGraph) and its weight as
+/// a raw double. The From vertex is implied by the row, so a typical sparse edge takes ~9 bytes instead of a 16 byte
+/// (From, To, Weight) record, and every pass reads ~1.8x less from disk.
+/// Every relaxation pass streams the file sequentially in blocks of blockSize bytes, so only the distance and predecessor arrays
+/// (and one block) are kept in memory.
+///
+/// Results are stored in the same _shortestPath / _previousVertex / _solved fields as BellmanFordAlgorithm,
+/// so ReconstructShortestPath works unchanged (only graph.Nodes is used there).
+/// </summary>
+class ExternalMemoryBellmanFord : public BellmanFordAlgorithm
+{
+public:
+    ExternalMemoryBellmanFord(size_t blockSize = 1 << 20)
+        : _blockSize(max(blockSize, _MaxEdgeBytes))
+    {
+    }
+
+    /// <summary>
+    /// Dumps all existing edges of the graph (Matrix values that are not INF) into the binary edge file.
+    /// Returns number of written edges.
+    /// </summary>
+    static size_t WriteEdgeFile(const Graph& graph, const string& fileName)
+    {
+        CompressedGraph compressed;
+        compressed.Build(graph);
+        return WriteEdgeFile(compressed, fileName);
+    }
+
+    static size_t WriteEdgeFile(const CompressedGraph& graph, const string& fileName)
+    {
+        ofstream file(fileName, ios::binary | ios::trunc);
+        if (!file)
+        {
+            cout << "Cannot open edge file " << fileName << " for writing." << endl;
+            return 0;
+        }
+
+        vector<uint8_t> row;
+        for (int from = 0; from < graph.VerticesNumber(); from++)
+        {
+            row.clear();
+            _PutVarint(row, (uint32_t)(graph.EdgeOffsets[from + 1] - graph.EdgeOffsets[from]));
+
+            int previous = 0;
+            graph.ForEachEdge(from, [&](int to, double weight)
+            {
+                _PutVarint(row, to - previous);
+                previous = to;
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&weight);
+                row.insert(row.end(), bytes, bytes + sizeof(double));
+            });
+
+            file.write(reinterpret_cast<const char*>(row.data()), row.size());
+        }
+
+        return graph.EdgesNumber();
+    }
+
+    /// <summary>
+    /// Same semantics as BellmanFordAlgorithm::FindPathsAndNegativeCycles, but edges are streamed from the edge file.
+    /// Passes stop as soon as one of them does not relax anything: for an on-disk graph every skipped pass is a full scan saved.
+    /// </summary>
+    bool FindPathsAndNegativeCycles(const string& fileName, int verticesNumber, int start)
+    {
+        _shortestPath.assign(verticesNumber, INF);
+        _previousVertex.assign(verticesNumber, -1);
+        _solved = false;
+
+        _shortestPath[start] = 0;
+
+        ifstream file(fileName, ios::binary);
+        if (!file)
+        {
+            cout << "Cannot open edge file " << fileName << "." << endl;
+            return false;
+        }
+
+        _block.resize(_blockSize);
+        _truncated = false;
+
+        // For each vertex, apply relaxation for all the edges to find PATH (if there are no negative cycles).
+        bool updated = true;
+        for (int k = 0; k < verticesNumber - 1 && updated; k++)
+        {
+            updated = _StreamPass(file, verticesNumber, false);
+        }
+
+        bool negativeCycles = false;
+
+        // Converged before V - 1 passes means the distances are final and no negative cycle is reachable.
+        // Otherwise run the algorithm a second time to DETECT which nodes are part of (or reachable from) a negative cycle.
+        if (updated)
+        {
+            for (int k = 0; k < verticesNumber - 1; k++)
+            {
+                if (_StreamPass(file, verticesNumber, true))
+                {
+                    negativeCycles = true;
+                }
+            }
+        }
+
+        if (_truncated)
+        {
+            cout << "Edge file " << fileName << " is truncated." << endl;
+            return false;
+        }
+
+        _solved = true;
+
+        return negativeCycles;
+    }
+
+private:
+    static constexpr size_t _MaxEdgeBytes = 5 + sizeof(double); // Longest varint of 32 bits and a weight.
+
+    size_t _blockSize;
+    vector<uint8_t> _block;
+    size_t _position = 0; // Next unread byte of _block.
+    size_t _end = 0;      // End of the bytes read into _block.
+    bool _truncated = false;
+
+    /// <summary>
+    /// Reads the whole edge file once, block by block, and relaxes every edge.
+    /// In detection mode improved vertices are marked as NEG_INF instead of updated.
+    /// </summary>
+    bool _StreamPass(ifstream& file, int verticesNumber, bool detectCycles)
+    {
+        file.clear();
+        file.seekg(0, ios::beg);
+        _position = 0;
+        _end = 0;
+
+        bool updated = false;
+        for (int from = 0; from < verticesNumber && !_truncated; from++)
+        {
+            uint32_t edgesNumber = 0;
+            if (!_ReadVarint(file, edgesNumber))
+            {
+                break;
+            }
+
+            int to = 0;
+            for (uint32_t e = 0; e < edgesNumber; e++)
+            {
+                uint32_t delta;
+                double weight;
+                if (!_ReadVarint(file, delta) || !_Read(file, &weight, sizeof(double)))
+                {
+                    break;
+                }
+                to += delta;
+
+                if (_shortestPath[to] > _shortestPath[from] + weight)
+                {
+                    if (detectCycles)
+                    {
+                        _shortestPath[to] = NEG_INF;
+                        _previousVertex[to] = -2;
+                    }
+                    else
+                    {
+                        _shortestPath[to] = _shortestPath[from] + weight;
+                        _previousVertex[to] = from;
+                    }
+                    updated = true;
+                }
+            }
+        }
+
+        return updated;
+    }
+
+    /// <summary>
+    /// Copies bytes from the block, reading the next block when the current one runs out. Sets _truncated at the end of file.
+    /// </summary>
+    bool _Read(ifstream& file, void* data, size_t bytes)
+    {
+        if (_end - _position < bytes && !_Refill(file, bytes))
+        {
+            return false;
+        }
+
+        memcpy(data, _block.data() + _position, bytes);
+        _position += bytes;
+        return true;
+    }
+
+    bool _ReadVarint(ifstream& file, uint32_t& value)
+    {
+        value = 0;
+        uint8_t byte;
+        int shift = 0;
+        do
+        {
+            if (_position == _end && !_Refill(file, 1))
+            {
+                return false;
+            }
+            byte = _block[_position++];
+            value |= (uint32_t)(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+
+        return true;
+    }
+
+    /// <summary>
+    /// Moves the unread tail of the block to its beginning and fills the rest from the file.
+    /// </summary>
+    bool _Refill(ifstream& file, size_t bytes)
+    {
+        size_t left = _end - _position;
+        memmove(_block.data(), _block.data() + _position, left);
+        file.read(reinterpret_cast<char*>(_block.data()) + left, _block.size() - left);
+        _position = 0;
+        _end = left + (size_t)file.gcount();
+
+        if (_end < bytes)
+        {
+            _truncated = true;
+            return false;
+        }
+        return true;
+    }
+
+    static void _PutVarint(vector<uint8_t>& bytes, uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            bytes.push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back((uint8_t)value);
+    }
+};
+
+#endif
@@ -0,0 +1,261 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Graph_Generator_H
+#define Graph_Generator_H
+
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <string>
+#include "pathFindingBase.h"
+
+/// <summary>
+/// Generators of synthetic graphs for validation and benchmarking.
+/// </summary>
+class GraphGenerator
+{
+public:
+    /// <summary>
+    /// Currency market: every currency gets a random "fair" price, the rate from i to j is price[j] / price[i]
+    /// reduced by the spread and shaken by a random noise. Edge weight is -LogE(rate), so a profitable arbitrage is a negative cycle.
+    /// With noise below the spread the graph has no negative cycles. Density is the share of existing (non INF) edges.
+    /// </summary>
+    static void RandomRates(Graph& graph, int verticesNumber, unsigned seed, double spread, double noise, double density = 1.0)
+    {
+        mt19937 random(seed);
+        uniform_real_distribution<double> price(0.01, 100.0);
+        uniform_real_distribution<double> shake(-noise, noise);
+        uniform_real_distribution<double> coin(0.0, 1.0);
+
+        graph.Clear();
+        vector<double> prices(verticesNumber);
+        for (int i = 0; i < verticesNumber; i++)
+        {
+            graph.Nodes.push_back({ "C" + to_string(i) });
+            prices[i] = price(random);
+        }
+
+        graph.Matrix.assign(verticesNumber, vector<double>(verticesNumber, INF));
+        for (int from = 0; from < verticesNumber; from++)
+        {
+            graph.Matrix[from][from] = 0.0;
+            for (int to = 0; to < verticesNumber; to++)
+            {
+                if (from == to || coin(random) > density)
+                {
+                    continue;
+                }
+
+                double rate = prices[to] / prices[from] * (1.0 - spread) * (1.0 + shake(random));
+                graph.Matrix[from][to] = -log(rate);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Venue level market for HierarchicalGraph: every currency is traded on every venue, vertex "C<c>@V<v>" has index v * currencies + c.
+    /// Conversions happen inside a venue (rates built like in RandomRates, each venue with its own noise), and moving a currency
+    /// between venues costs transferCost.
+    /// </summary>
+    static void RandomVenues(Graph& graph, vector<int>& currencyOf, int currenciesNumber, int venuesNumber, unsigned seed,
+        double spread, double noise, double transferCost)
+    {
+        mt19937 random(seed);
+        uniform_real_distribution<double> price(0.01, 100.0);
+        uniform_real_distribution<double> shake(-noise, noise);
+
+        vector<double> prices(currenciesNumber);
+        for (int c = 0; c < currenciesNumber; c++)
+        {
+            prices[c] = price(random);
+        }
+
+        int verticesNumber = currenciesNumber * venuesNumber;
+        graph.Clear();
+        currencyOf.assign(verticesNumber, 0);
+        for (int v = 0; v < venuesNumber; v++)
+        {
+            for (int c = 0; c < currenciesNumber; c++)
+            {
+                graph.Nodes.push_back({ "C" + to_string(c) + "@V" + to_string(v) });
+                currencyOf[v * currenciesNumber + c] = c;
+            }
+        }
+
+        graph.Matrix.assign(verticesNumber, vector<double>(verticesNumber, INF));
+        for (int from = 0; from < verticesNumber; from++)
+        {
+            graph.Matrix[from][from] = 0.0;
+            for (int to = 0; to < verticesNumber; to++)
+            {
+                if (from == to)
+                {
+                    continue;
+                }
+
+                if (currencyOf[from] == currencyOf[to])
+                {
+                    graph.Matrix[from][to] = transferCost;
+                }
+                else if (from / currenciesNumber == to / currenciesNumber) // Same venue.
+                {
+                    double rate = prices[currencyOf[to]] / prices[currencyOf[from]] * (1.0 - spread) * (1.0 + shake(random));
+                    graph.Matrix[from][to] = -log(rate);
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Long negative chain 0 -> V-1 -> V-2 -> ... -> 1 (weight -1 per edge, numbered against the scan order of the matrix) with
+    /// shortcuts 0 -> v of weight 0. Every shortcut gives a label which the chain then improves one step at a time, so passes
+    /// of Bellman-Ford and FIFO queues move the final labels one edge per pass: V passes of V vertices.
+    /// When closed, edge 1 -> 0 makes the whole chain a negative cycle of V edges (weight -0.5), the slowest one to detect.
+    /// </summary>
+    static void NegativeChain(Graph& graph, int verticesNumber, bool closed)
+    {
+        _Empty(graph, verticesNumber);
+        for (int v = 1; v < verticesNumber; v++)
+        {
+            graph.Matrix[0][v] = 0.0;
+            int next = v == verticesNumber - 1 ? 0 : v + 1; // Chain goes from next to v.
+            graph.Matrix[next][v] = -1.0;
+        }
+
+        if (closed && verticesNumber > 1)
+        {
+            graph.Matrix[1][0] = verticesNumber - 1.5;
+        }
+    }
+
+    /// <summary>
+    /// Grid of rows x columns vertices (index row * columns + column) with edges both ways between neighbours, weights in [1, 10],
+    /// reweighted by random potentials so that many edges are negative while cycles keep their weight.
+    /// When planted, one random unit square gets clockwise edges of total weight -1 (a negative cycle of 4 edges).
+    /// </summary>
+    static void GridWithCycle(Graph& graph, int rows, int columns, unsigned seed, bool planted)
+    {
+        mt19937 random(seed);
+        uniform_real_distribution<double> weight(1.0, 10.0);
+
+        _Empty(graph, rows * columns);
+        for (int r = 0; r < rows; r++)
+        {
+            for (int c = 0; c < columns; c++)
+            {
+                int v = r * columns + c;
+                if (c + 1 < columns)
+                {
+                    graph.Matrix[v][v + 1] = weight(random);
+                    graph.Matrix[v + 1][v] = weight(random);
+                }
+                if (r + 1 < rows)
+                {
+                    graph.Matrix[v][v + columns] = weight(random);
+                    graph.Matrix[v + columns][v] = weight(random);
+                }
+            }
+        }
+
+        if (planted && rows > 1 && columns > 1)
+        {
+            int corner = uniform_int_distribution<int>(0, rows - 2)(random) * columns + uniform_int_distribution<int>(0, columns - 2)(random);
+            int square[] = { corner, corner + 1, corner + columns + 1, corner + columns };
+            for (int i = 0; i < 4; i++)
+            {
+                graph.Matrix[square[i]][square[(i + 1) % 4]] = -0.25;
+            }
+        }
+
+        _Reweight(graph, random, 20.0);
+    }
+
+    /// <summary>
+    /// Grid against queue based label-correcting solvers (SPFA): rows x columns vertices, cheap random edges inside a row,
+    /// expensive random edges down to the next row, and some detour edges back up. Vertex indices are shuffled (0 stays the top
+    /// left corner) and edges are reweighted by random potentials, so labels found early are mostly wrong and corrections
+    /// travel through long chains of already scanned vertices again and again. No negative cycles.
+    /// </summary>
+    static void SpfaKiller(Graph& graph, int rows, int columns, unsigned seed)
+    {
+        mt19937 random(seed);
+        uniform_real_distribution<double> cheap(0.0, 1.0);
+        uniform_real_distribution<double> expensive(50.0, 100.0);
+
+        int verticesNumber = rows * columns;
+        vector<int> index(verticesNumber);
+        for (int v = 0; v < verticesNumber; v++)
+        {
+            index[v] = v;
+        }
+        shuffle(index.begin() + 1, index.end(), random);
+
+        _Empty(graph, verticesNumber);
+        for (int r = 0; r < rows; r++)
+        {
+            for (int c = 0; c < columns; c++)
+            {
+                int v = index[r * columns + c];
+                if (c + 1 < columns)
+                {
+                    graph.Matrix[v][index[r * columns + c + 1]] = cheap(random);
+                    graph.Matrix[index[r * columns + c + 1]][v] = cheap(random);
+                }
+                if (r + 1 < rows)
+                {
+                    graph.Matrix[v][index[(r + 1) * columns + c]] = expensive(random);
+                    graph.Matrix[index[(r + 1) * columns + c]][v] = expensive(random) * 2;
+                }
+            }
+        }
+
+        _Reweight(graph, random, 20.0);
+    }
+
+private:
+    /// <summary>
+    /// Vertices named "C<i>", zero diagonal and no edges.
+    /// </summary>
+    static void _Empty(Graph& graph, int verticesNumber)
+    {
+        graph.Clear();
+        for (int i = 0; i < verticesNumber; i++)
+        {
+            graph.Nodes.push_back({ "C" + to_string(i) });
+        }
+
+        graph.Matrix.assign(verticesNumber, vector<double>(verticesNumber, INF));
+        for (int v = 0; v < verticesNumber; v++)
+        {
+            graph.Matrix[v][v] = 0.0;
+        }
+    }
+
+    /// <summary>
+    /// w(from, to) += p[from] - p[to] with random p in [0, range]: weight of every cycle stays the same.
+    /// </summary>
+    static void _Reweight(Graph& graph, mt19937& random, double range)
+    {
+        uniform_real_distribution<double> potential(0.0, range);
+        vector<double> p(graph.Matrix.size());
+        for (double& value : p)
+        {
+            value = potential(random);
+        }
+
+        for (size_t from = 0; from < graph.Matrix.size(); from++)
+        {
+            for (size_t to = 0; to < graph.Matrix.size(); to++)
+            {
+                if (from != to && graph.Matrix[from][to] != INF)
+                {
+                    graph.Matrix[from][to] += p[from] - p[to];
+                }
+            }
+        }
+    }
+};
+
+#endif
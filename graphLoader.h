@@ -0,0 +1,374 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Graph_Loader_H
+#define Graph_Loader_H
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+#include <climits>
+#include "pathFindingBase.h"
+#include "compressedGraph.h"
+
+/// <summary>
+/// Loaders of standard shortest path benchmark files into CompressedGraph:
+/// - DIMACS shortest path format (.gr): "c" comment lines, one "p sp <vertices> <arcs>" line and "a <from> <to> <weight>" arcs;
+/// - Matrix Market coordinate format (.mtx): "%%MatrixMarket matrix coordinate <real|integer|pattern> <general|symmetric>"
+///   banner, "%" comments, "<rows> <columns> <entries>" size line and "<row> <column> [<value>]" entries (row -> column edges,
+///   weight 1 for pattern matrices, both directions for symmetric ones).
+/// Vertices are 1-based in both formats. Other DIMACS line types, an arc (entry) count different from the problem (size) line and
+/// vertex counts above INT_MAX are rejected.
+///
+/// The whole file is read with a single read into memory, and its lines are then split into one chunk per thread (at line
+/// boundaries) and parsed in parallel with strtol/strtod directly on the buffer; every thread collects edges in its own vector.
+/// Problems are reported to cout and the loader returns false, like the other file based classes.
+/// </summary>
+class GraphLoader
+{
+public:
+    GraphLoader(int threadsNumber = 0)
+        : _threadsNumber(threadsNumber > 0 ? threadsNumber : max(1, (int)thread::hardware_concurrency()))
+    {
+    }
+
+    bool LoadDimacs(const string& fileName, CompressedGraph& graph)
+    {
+        string text;
+        if (!_ReadFile(fileName, text))
+        {
+            return false;
+        }
+
+        // Problem line, anywhere before the arcs.
+        size_t problem = text.compare(0, 2, "p ") == 0 ? 0 : text.find("\np ");
+        long long verticesNumber = 0, arcsNumber = 0;
+        if (problem == string::npos ||
+            sscanf(text.c_str() + problem + (problem == 0 ? 0 : 1), "p sp %lld %lld", &verticesNumber, &arcsNumber) != 2 ||
+            verticesNumber <= 0 || arcsNumber < 0)
+        {
+            cout << "File " << fileName << " has no 'p sp' problem line." << endl;
+            return false;
+        }
+        if (verticesNumber > INT_MAX)
+        {
+            cout << "File " << fileName << " has too many vertices: " << verticesNumber << "." << endl;
+            return false;
+        }
+
+        vector<StreamEdge> edges;
+        bool parsed = _ParseLines(fileName, text, 0, edges, [verticesNumber](const char* at, const char* end, vector<StreamEdge>& output)
+        {
+            if (*at == 'c' || *at == 'p')
+            {
+                return true; // Comments and the problem line.
+            }
+            if (*at != 'a')
+            {
+                return false;
+            }
+
+            at++;
+            long long from, to;
+            double weight;
+            if (!_ReadInteger(at, end, from) || !_ReadInteger(at, end, to) || !_ReadReal(at, end, weight) ||
+                from < 1 || from > verticesNumber || to < 1 || to > verticesNumber)
+            {
+                return false;
+            }
+
+            output.push_back({ (int)from - 1, (int)to - 1, weight });
+            return true;
+        });
+
+        if (parsed && (long long)edges.size() != arcsNumber)
+        {
+            cout << "File " << fileName << " has " << edges.size() << " arcs, but its problem line declares " << arcsNumber << "." << endl;
+            return false;
+        }
+
+        if (parsed)
+        {
+            graph.Build((int)verticesNumber, edges);
+        }
+        return parsed;
+    }
+
+    bool LoadMatrixMarket(const string& fileName, CompressedGraph& graph)
+    {
+        string text;
+        if (!_ReadFile(fileName, text))
+        {
+            return false;
+        }
+
+        string banner = text.substr(0, text.find('\n'));
+        transform(banner.begin(), banner.end(), banner.begin(), [](char c) { return (char)tolower(c); });
+        string object, format, field, symmetry;
+        istringstream(banner.substr(min(banner.size(), strlen("%%matrixmarket")))) >> object >> format >> field >> symmetry;
+        if (banner.compare(0, strlen("%%matrixmarket"), "%%matrixmarket") != 0 || object != "matrix" || format != "coordinate" ||
+            (field != "real" && field != "integer" && field != "pattern") || (symmetry != "general" && symmetry != "symmetric"))
+        {
+            cout << "File " << fileName << " is not a real, integer or pattern coordinate Matrix Market file "
+                 << "with general or symmetric storage." << endl;
+            return false;
+        }
+
+        // Size line is the first line after the banner which is not a comment.
+        size_t position = text.find('\n');
+        while (position != string::npos && (text[position + 1] == '%' || text[position + 1] == '\n' || text[position + 1] == '\r'))
+        {
+            position = text.find('\n', position + 1);
+        }
+        long long rows = 0, columns = 0, entries = 0;
+        if (position == string::npos || sscanf(text.c_str() + position + 1, "%lld %lld %lld", &rows, &columns, &entries) != 3 || rows <= 0 || columns <= 0 ||
+            entries < 0)
+        {
+            cout << "File " << fileName << " has no size line." << endl;
+            return false;
+        }
+        position = text.find('\n', position + 1);
+
+        long long verticesNumber = max(rows, columns);
+        if (verticesNumber > INT_MAX)
+        {
+            cout << "File " << fileName << " has too many vertices: " << verticesNumber << "." << endl;
+            return false;
+        }
+        bool pattern = field == "pattern";
+        bool symmetric = symmetry == "symmetric";
+        vector<StreamEdge> edges;
+        bool parsed = position == string::npos || _ParseLines(fileName, text, position + 1, edges,
+            [verticesNumber, pattern, symmetric](const char* at, const char* end, vector<StreamEdge>& output)
+        {
+            if (*at == '%')
+            {
+                return true;
+            }
+
+            long long row, column;
+            double weight = 1.0;
+            if (!_ReadInteger(at, end, row) || !_ReadInteger(at, end, column) || (!pattern && !_ReadReal(at, end, weight)) ||
+                row < 1 || row > verticesNumber || column < 1 || column > verticesNumber)
+            {
+                return false;
+            }
+
+            output.push_back({ (int)row - 1, (int)column - 1, weight });
+            if (symmetric && row != column)
+            {
+                output.push_back({ (int)column - 1, (int)row - 1, weight });
+            }
+            return true;
+        });
+
+        // Off-diagonal entries of a symmetric file gave two edges each.
+        long long diagonal = 0;
+        for (const StreamEdge& edge : edges)
+        {
+            diagonal += edge.From == edge.To;
+        }
+        long long entriesRead = symmetric ? ((long long)edges.size() + diagonal) / 2 : (long long)edges.size();
+        if (parsed && entriesRead != entries)
+        {
+            cout << "File " << fileName << " has " << entriesRead << " entries, but its size line declares " << entries << "." << endl;
+            return false;
+        }
+
+        if (parsed)
+        {
+            graph.Build((int)verticesNumber, edges);
+        }
+        return parsed;
+    }
+
+    /// <summary>
+    /// Divides all weights by the largest absolute weight. Benchmark weights (e.g. road distances) summed over long paths would
+    /// otherwise reach INF, which the solvers use as "no edge / not reached".
+    /// </summary>
+    static void Normalize(CompressedGraph& graph)
+    {
+        double largest = 0;
+        for (double weight : graph.Weights)
+        {
+            largest = max(largest, fabs(weight));
+        }
+
+        if (largest > 0)
+        {
+            for (double& weight : graph.Weights)
+            {
+                weight /= largest;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Negative weight transformation: w(from, to) += p[from] - p[to] with random p in [0, range]. Weight of every cycle stays the same
+    /// (so a graph with non-negative weights gets no negative cycle) and shortest paths stay the same, but many edges become negative.
+    /// </summary>
+    static void Reweight(CompressedGraph& graph, unsigned seed, double range)
+    {
+        mt19937 random(seed);
+        uniform_real_distribution<double> potential(0.0, range);
+        vector<double> p(graph.VerticesNumber());
+        for (double& value : p)
+        {
+            value = potential(random);
+        }
+
+        for (int from = 0; from < graph.VerticesNumber(); from++)
+        {
+            size_t e = graph.EdgeOffsets[from];
+            graph.ForEachEdge(from, [&](int to, double weight)
+            {
+                graph.Weights[e++] = weight + p[from] - p[to];
+            });
+        }
+    }
+
+private:
+    int _threadsNumber;
+
+    bool _ReadFile(const string& fileName, string& text)
+    {
+        ifstream file(fileName, ios::binary | ios::ate);
+        if (!file)
+        {
+            cout << "Cannot open graph file " << fileName << "." << endl;
+            return false;
+        }
+
+        text.resize((size_t)file.tellg());
+        file.seekg(0, ios::beg);
+        if (!file.read(&text[0], text.size()))
+        {
+            cout << "Cannot read graph file " << fileName << "." << endl;
+            return false;
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// Calls parse(lineBegin, lineEnd, edges) for every non empty line of text from begin on, in one chunk per thread.
+    /// Reports the first line parse rejects.
+    /// </summary>
+    template <typename LineParser>
+    bool _ParseLines(const string& fileName, const string& text, size_t begin, vector<StreamEdge>& edges, LineParser parse)
+    {
+        int threadsNumber = max(1, min(_threadsNumber, (int)((text.size() - begin) / (1 << 16)) + 1));
+        vector<size_t> bounds(threadsNumber + 1, text.size());
+        bounds[0] = begin;
+        for (int t = 1; t < threadsNumber; t++)
+        {
+            size_t split = text.find('\n', max(bounds[t - 1], begin + (text.size() - begin) * t / threadsNumber));
+            bounds[t] = split == string::npos ? text.size() : split + 1;
+        }
+
+        vector<vector<StreamEdge>> buffers(threadsNumber);
+        vector<size_t> failedAt(threadsNumber, string::npos);
+        vector<thread> threads;
+        threads.reserve(threadsNumber);
+        for (int t = 0; t < threadsNumber; t++)
+        {
+            threads.emplace_back([&text, &bounds, &buffers, &failedAt, &parse, t]()
+            {
+                const char* data = text.c_str();
+                for (size_t line = bounds[t]; line < bounds[t + 1]; )
+                {
+                    const char* end = (const char*)memchr(data + line, '\n', bounds[t + 1] - line);
+                    size_t next = end == nullptr ? bounds[t + 1] : end - data + 1;
+                    if (end == nullptr)
+                    {
+                        end = data + bounds[t + 1];
+                    }
+
+                    const char* at = data + line;
+                    while (at < end && (*at == ' ' || *at == '\t'))
+                    {
+                        at++;
+                    }
+                    if (at < end && *at != '\r' && !parse(at, end, buffers[t]))
+                    {
+                        failedAt[t] = line;
+                        return;
+                    }
+                    line = next;
+                }
+            });
+        }
+        for (thread& worker : threads)
+        {
+            worker.join();
+        }
+
+        for (int t = 0; t < threadsNumber; t++)
+        {
+            if (failedAt[t] != string::npos)
+            {
+                cout << "File " << fileName << ": malformed line " << count(text.begin(), text.begin() + failedAt[t], '\n') + 1 << "." << endl;
+                return false;
+            }
+        }
+
+        size_t edgesNumber = 0;
+        for (const vector<StreamEdge>& buffer : buffers)
+        {
+            edgesNumber += buffer.size();
+        }
+        edges.clear();
+        edges.reserve(edgesNumber);
+        for (const vector<StreamEdge>& buffer : buffers)
+        {
+            edges.insert(edges.end(), buffer.begin(), buffer.end());
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// Number parsers which do not leave the line (strtol and strtod would skip a line break as white space).
+    /// </summary>
+    static bool _ReadInteger(const char*& at, const char* end, long long& value)
+    {
+        if (!_SkipSpaces(at, end))
+        {
+            return false;
+        }
+        char* next;
+        value = strtoll(at, &next, 10);
+        bool read = next != at && next <= end;
+        at = next;
+        return read;
+    }
+
+    static bool _ReadReal(const char*& at, const char* end, double& value)
+    {
+        if (!_SkipSpaces(at, end))
+        {
+            return false;
+        }
+        char* next;
+        value = strtod(at, &next);
+        bool read = next != at && next <= end;
+        at = next;
+        return read;
+    }
+
+    static bool _SkipSpaces(const char*& at, const char* end)
+    {
+        while (at < end && (*at == ' ' || *at == '\t'))
+        {
+            at++;
+        }
+        return at < end && *at != '\r' && *at != '\n';
+    }
+};
+
+#endif
@@ -0,0 +1,166 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Hierarchical_Graph_H
+#define Hierarchical_Graph_H
+
+#include <string>
+#include <algorithm>
+#include "pathFindingBase.h"
+#include "bellmanFordAlgorithm.h"
+#include "cyclePruning.h"
+
+/// <summary>
+/// Two level model of the market: a fine graph of venue vertices (one instrument of one currency on one venue) and the coarse
+/// currency graph, its quotient by currency. A coarse edge keeps the best fine edge between the two currencies, and transfers
+/// between venues of the same currency are dropped.
+///
+/// With non-negative transfer costs every fine cycle maps to a coarse closed walk which is not more expensive, so a coarse graph
+/// without negative cycles proves the fine graph has none. Otherwise the coarse cycle names candidate currencies and only their
+/// venues (less the ones CyclePruning drops) are solved, through a mask over the fine matrix. If that neighborhood has no negative
+/// cycle it grows by one coarse hop at a time, and the full fine graph is solved only as the last resort.
+/// Answers are the same as a full fine solve.
+/// </summary>
+class HierarchicalGraph
+{
+public:
+    Graph Coarse;
+    vector<int> CurrencyOf; // Currency of every fine vertex.
+
+    /// <summary>
+    /// Builds the coarse graph. Fine vertex v belongs to currency currencyOf[v], an index in currencyNames.
+    /// </summary>
+    void Build(const Graph& fine, const vector<int>& currencyOf, const vector<string>& currencyNames)
+    {
+        int currenciesNumber = currencyNames.size();
+        int fineNumber = fine.Matrix.size();
+        CurrencyOf = currencyOf;
+
+        Coarse.Clear();
+        for (const string& name : currencyNames)
+        {
+            Coarse.Nodes.push_back({ name });
+        }
+        Coarse.Matrix.assign(currenciesNumber, vector<double>(currenciesNumber, INF));
+        for (int c = 0; c < currenciesNumber; c++)
+        {
+            Coarse.Matrix[c][c] = 0.0;
+        }
+
+        _exactScreen = true;
+        for (int from = 0; from < fineNumber; from++)
+        {
+            for (int to = 0; to < fineNumber; to++)
+            {
+                double weight = fine.Matrix[from][to];
+                if (from == to || weight == INF) // Edge not exists
+                {
+                    continue;
+                }
+
+                int a = currencyOf[from];
+                int b = currencyOf[to];
+                if (a == b)
+                {
+                    _exactScreen = _exactScreen && weight >= 0; // Negative transfer: coarse graph is not a lower bound any more.
+                    continue;
+                }
+                Coarse.Matrix[a][b] = min(Coarse.Matrix[a][b], weight);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Returns a negative cycle of the fine graph (fine vertex indexes in edge order), or empty vector if there is none.
+    /// </summary>
+    vector<int> FindNegativeCycle(Graph& fine)
+    {
+        _fineVerticesSolved = 0;
+        _refinements = 0;
+
+        int currenciesNumber = Coarse.Matrix.size();
+        vector<char> candidate(currenciesNumber, 0);
+        if (_exactScreen)
+        {
+            BellmanFordAlgorithm coarseSolver;
+            vector<int> coarseCycle = coarseSolver.FindAnyNegativeCycle(Coarse);
+            if (coarseCycle.empty())
+            {
+                return {};
+            }
+            for (int c : coarseCycle)
+            {
+                candidate[c] = 1;
+            }
+        }
+        else
+        {
+            candidate.assign(currenciesNumber, 1);
+        }
+
+        while (true)
+        {
+            _refinements++;
+            vector<char> mask(fine.Matrix.size());
+            for (int v = 0; v < (int)fine.Matrix.size(); v++)
+            {
+                mask[v] = candidate[CurrencyOf[v]];
+            }
+            _pruning.Compute(fine, mask);
+            _fineVerticesSolved += _pruning.ActiveNumber;
+
+            vector<int> cycle = _solver.FindAnyNegativeCycle(fine, _pruning.Active);
+            if (!cycle.empty())
+            {
+                return cycle;
+            }
+
+            if (find(candidate.begin(), candidate.end(), 0) == candidate.end())
+            {
+                return {}; // Whole graph solved.
+            }
+
+            // One more coarse hop (either direction) around the candidates.
+            vector<char> grown = candidate;
+            for (int a = 0; a < currenciesNumber; a++)
+            {
+                for (int b = 0; b < currenciesNumber; b++)
+                {
+                    if (candidate[a] && (Coarse.Matrix[a][b] != INF || Coarse.Matrix[b][a] != INF))
+                    {
+                        grown[b] = 1;
+                    }
+                }
+            }
+            if (grown == candidate)
+            {
+                grown.assign(currenciesNumber, 1); // Candidates close a component: the rest is solved as a whole.
+            }
+            candidate = grown;
+        }
+    }
+
+    /// <summary>
+    /// Sum over refinement steps of fine vertices seen by the solver in the last FindNegativeCycle.
+    /// </summary>
+    size_t FineVerticesSolved() const
+    {
+        return _fineVerticesSolved;
+    }
+
+    int Refinements() const
+    {
+        return _refinements;
+    }
+
+private:
+    bool _exactScreen = true;
+    size_t _fineVerticesSolved = 0;
+    int _refinements = 0;
+    CyclePruning _pruning;
+    BellmanFordAlgorithm _solver;
+
+};
+
+#endif
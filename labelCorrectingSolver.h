@@ -0,0 +1,249 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Label_Correcting_Solver_H
+#define Label_Correcting_Solver_H
+
+#include "pathFindingBase.h"
+#include "bellmanFordAlgorithm.h"
+#include "compressedGraph.h"
+#include "vertexQueue.h"
+
+/// <summary>
+/// Plain FIFO queue discipline for LabelCorrectingSolver, as in BellmanFordAlgorithm::FindPathOnly.
+/// A discipline decides where an improved vertex goes (Push) and which vertex is scanned next (Pop); the vertex queue itself
+/// keeps every vertex at most once. Push gets the label the vertex had before the improvement, so disciplines tracking
+/// labels of queued vertices can update them.
+/// </summary>
+class FifoPolicy
+{
+public:
+    void Clear()
+    {
+    }
+
+    void Push(VertexQueue& queue, int v, double, const vector<double>&)
+    {
+        queue.PushBack(v);
+    }
+
+    int Pop(VertexQueue& queue, const vector<double>&)
+    {
+        return queue.PopFront();
+    }
+};
+
+/// <summary>
+/// Small Label First: a vertex with label smaller than the label of the front vertex goes to the front, otherwise to the back.
+/// </summary>
+class SmallLabelFirstPolicy
+{
+public:
+    void Clear()
+    {
+    }
+
+    void Push(VertexQueue& queue, int v, double, const vector<double>& distance)
+    {
+        if (!queue.Empty() && distance[v] < distance[queue.Front()])
+        {
+            queue.PushFront(v);
+        }
+        else
+        {
+            queue.PushBack(v);
+        }
+    }
+
+    int Pop(VertexQueue& queue, const vector<double>&)
+    {
+        return queue.PopFront();
+    }
+};
+
+/// <summary>
+/// Large Label Last: while the front vertex has label above the average label of the queue, it is moved to the back.
+/// </summary>
+class LargeLabelLastPolicy
+{
+public:
+    void Clear()
+    {
+        _sum = 0;
+    }
+
+    void Push(VertexQueue& queue, int v, double previous, const vector<double>& distance)
+    {
+        if (queue.Contains(v))
+        {
+            _sum += distance[v] - previous;
+            return;
+        }
+
+        queue.PushBack(v);
+        _sum += distance[v];
+    }
+
+    int Pop(VertexQueue& queue, const vector<double>& distance)
+    {
+        // Some vertex is not above the average; the bound only protects against rounding of _sum.
+        double average = _sum / queue.Size();
+        for (int moved = 0; moved < queue.Size() && distance[queue.Front()] > average; moved++)
+        {
+            queue.PushBack(queue.PopFront());
+        }
+
+        int v = queue.PopFront();
+        _sum -= distance[v];
+        return v;
+    }
+
+protected:
+    double _sum = 0; // Sum of labels of the queued vertices.
+};
+
+/// <summary>
+/// Both heuristics: Small Label First on push, Large Label Last on pop.
+/// </summary>
+class SmallLabelFirstLargeLabelLastPolicy : public LargeLabelLastPolicy
+{
+public:
+    void Push(VertexQueue& queue, int v, double previous, const vector<double>& distance)
+    {
+        if (queue.Contains(v))
+        {
+            _sum += distance[v] - previous;
+            return;
+        }
+
+        if (!queue.Empty() && distance[v] < distance[queue.Front()])
+        {
+            queue.PushFront(v);
+        }
+        else
+        {
+            queue.PushBack(v);
+        }
+        _sum += distance[v];
+    }
+};
+
+/// <summary>
+/// Label-correcting shortest paths (FindPathOnly generalized to a deque) with the queue discipline chosen at compile time,
+/// so the policy calls are inlined into the relaxation loop.
+/// Unlike FindPathOnly it detects negative cycles: every label remembers the number of edges of its path, and a path of
+/// V edges repeats a vertex, which only an improvement through a negative cycle can produce.
+/// Counts scans and relaxations, the measure the policies are compared by.
+/// </summary>
+template <class QueuePolicy>
+class LabelCorrectingSolver : public BellmanFordAlgorithm
+{
+public:
+    /// <summary>
+    /// Returns true if a negative cycle is reachable from start (then distances are not final and _solved stays false).
+    /// </summary>
+    bool FindPathsAndNegativeCycles(Graph& graph, int start)
+    {
+        return _Solve((int)graph.Matrix.size(), start, [&graph](int from, auto relax)
+        {
+            const vector<double>& row = graph.Matrix[from];
+            for (int to = 0; to < (int)row.size(); to++)
+            {
+                if (row[to] != INF) // Edge exists
+                {
+                    relax(to, row[to]);
+                }
+            }
+        });
+    }
+
+    /// <summary>
+    /// Same on CompressedGraph: a scan visits only the existing edges, so big sparse graphs (e.g. loaded by GraphLoader) fit.
+    /// </summary>
+    bool FindPathsAndNegativeCycles(const CompressedGraph& graph, int start)
+    {
+        return _Solve(graph.VerticesNumber(), start, [&graph](int from, auto relax)
+        {
+            graph.ForEachEdge(from, relax);
+        });
+    }
+
+    /// <summary>
+    /// Vertices taken from the queue by the last run.
+    /// </summary>
+    size_t Scans() const
+    {
+        return _scans;
+    }
+
+    /// <summary>
+    /// Successful (label improving) relaxations of the last run.
+    /// </summary>
+    size_t Relaxations() const
+    {
+        return _relaxations;
+    }
+
+private:
+    QueuePolicy _policy;
+    vector<int> _pathEdges;
+    size_t _scans = 0;
+    size_t _relaxations = 0;
+
+    /// <summary>
+    /// forEachEdge(from, relax) calls relax(to, weight) for every edge leaving from.
+    /// </summary>
+    template <typename EdgeScanner>
+    bool _Solve(int verticesNumber, int start, EdgeScanner forEachEdge)
+    {
+        _shortestPath.assign(verticesNumber, INF);
+        _previousVertex.assign(verticesNumber, -1);
+        _solved = false;
+        _pathEdges.assign(verticesNumber, 0);
+        _scans = 0;
+        _relaxations = 0;
+
+        _shortestPath[start] = 0;
+
+        _queue.Reset(verticesNumber);
+        _policy.Clear();
+        _policy.Push(_queue, start, INF, _shortestPath);
+
+        bool negativeCycle = false;
+        while (!_queue.Empty() && !negativeCycle)
+        {
+            int from = _policy.Pop(_queue, _shortestPath);
+            _scans++;
+
+            forEachEdge(from, [&](int to, double weight)
+            {
+                double newDistance = _shortestPath[from] + weight;
+                if (negativeCycle || _shortestPath[to] <= newDistance)
+                {
+                    return;
+                }
+
+                double previous = _shortestPath[to];
+                _shortestPath[to] = newDistance;
+                _previousVertex[to] = from;
+                _relaxations++;
+
+                _pathEdges[to] = _pathEdges[from] + 1;
+                if (_pathEdges[to] >= verticesNumber)
+                {
+                    negativeCycle = true;
+                    return;
+                }
+
+                _policy.Push(_queue, to, previous, _shortestPath);
+            });
+        }
+
+        _solved = !negativeCycle;
+
+        return negativeCycle;
+    }
+};
+
+#endif
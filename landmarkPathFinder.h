@@ -0,0 +1,233 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Landmark_Path_Finder_H
+#define Landmark_Path_Finder_H
+
+#include <iostream>
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include "pathFindingBase.h"
+#include "bellmanFordAlgorithm.h"
+
+/// <summary>
+/// Goal directed point-to-point queries (A*, landmarks and triangle inequality - ALT) on a graph without negative cycles.
+///
+/// Preprocessing, once per graph snapshot:
+/// - Bellman-Ford from a virtual source gives potentials p with non-negative reduced costs w + p[from] - p[to];
+/// - a few landmark vertices are picked (each one farthest from the ones picked before) and Dijkstra computes
+///   reduced distances from and to every landmark.
+/// A query then runs A* on reduced costs with the heuristic max over landmarks of
+/// dist(L, finish) - dist(L, v) and dist(v, L) - dist(finish, L), which settles only vertices "towards" the finish.
+/// Real path cost is the reduced one corrected by potentials: reduced - p[start] + p[finish].
+/// </summary>
+class LandmarkPathFinder
+{
+public:
+    double _pathCost = INF;
+    int _settled = 0; // Vertices settled by the last query.
+
+    /// <summary>
+    /// Returns false if the graph contains a negative cycle (no potentials exist).
+    /// </summary>
+    bool Preprocess(const Graph& graph, int landmarksNumber)
+    {
+        _verticesNumber = graph.Nodes.size();
+        _landmarks.clear();
+        _fromLandmark.clear();
+        _toLandmark.clear();
+
+        if (!BellmanFordAlgorithm::FindPotentials(graph, _potential))
+        {
+            return false;
+        }
+
+        vector<double> closest(_verticesNumber, UNREACHED); // Reduced distance from the nearest landmark picked so far.
+        int next = 0;
+        for (int i = 0; i < min(landmarksNumber, _verticesNumber); i++)
+        {
+            _landmarks.push_back(next);
+            _fromLandmark.push_back(_Dijkstra(graph, next, false));
+            _toLandmark.push_back(_Dijkstra(graph, next, true));
+
+            // Next landmark is the reachable vertex farthest from all picked ones.
+            double farthest = -1;
+            for (int v = 0; v < _verticesNumber; v++)
+            {
+                if (_fromLandmark.back()[v] != UNREACHED)
+                {
+                    closest[v] = closest[v] == UNREACHED ? _fromLandmark.back()[v] : min(closest[v], _fromLandmark.back()[v]);
+                }
+
+                double away = closest[v] == UNREACHED ? numeric_limits<double>::max() : closest[v];
+                if (find(_landmarks.begin(), _landmarks.end(), v) == _landmarks.end() && away > farthest)
+                {
+                    farthest = away;
+                    next = v;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Returns path start ... finish and prints it like BellmanFordAlgorithm::ReconstructShortestPath.
+    /// </summary>
+    vector<int> FindPath(Graph& graph, int start, int finish)
+    {
+        vector<double> distance(_verticesNumber, UNREACHED);
+        vector<int> previous(_verticesNumber, -1);
+        vector<char> settled(_verticesNumber, 0);
+        _settled = 0;
+        _pathCost = INF;
+
+        priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> queue;
+        distance[start] = 0;
+        queue.push({ _Heuristic(start, finish), start });
+
+        while (!queue.empty())
+        {
+            int from = queue.top().second;
+            queue.pop();
+            if (settled[from])
+            {
+                continue;
+            }
+            settled[from] = 1;
+            _settled++;
+
+            if (from == finish)
+            {
+                break;
+            }
+
+            for (int to = 0; to < _verticesNumber; to++)
+            {
+                if (to == from || graph.Matrix[from][to] == INF || settled[to]) // Edge not exists
+                {
+                    continue;
+                }
+
+                double candidate = distance[from] + _ReducedCost(graph, from, to);
+                if (candidate < distance[to])
+                {
+                    distance[to] = candidate;
+                    previous[to] = from;
+                    queue.push({ candidate + _Heuristic(to, finish), to });
+                }
+            }
+        }
+
+        if (distance[finish] == UNREACHED)
+        {
+            cout << "Path from " << start << " to " << finish << " is : Not reachable." << endl;
+            return {};
+        }
+
+        _pathCost = distance[finish] - _potential[start] + _potential[finish];
+
+        vector<int> path;
+        for (int at = finish; at != -1; at = previous[at])
+        {
+            path.push_back(at);
+        }
+        reverse(path.begin(), path.end());
+
+        cout << "Path from " << start << " to " << finish << " is : ";
+        for (int i = 0; i < (int)path.size(); i++)
+        {
+            cout << path[i] << "(" << graph.Nodes[path[i]].Name << ") ";
+        }
+        cout << endl;
+
+        return path;
+    }
+
+    const vector<int>& Landmarks() const
+    {
+        return _landmarks;
+    }
+
+private:
+    static constexpr double UNREACHED = numeric_limits<double>::infinity();
+
+    int _verticesNumber = 0;
+    vector<double> _potential;
+    vector<int> _landmarks;
+    vector<vector<double>> _fromLandmark; // Reduced distances landmark -> v.
+    vector<vector<double>> _toLandmark;   // Reduced distances v -> landmark.
+
+    double _ReducedCost(const Graph& graph, int from, int to) const
+    {
+        // Rounding may give tiny negative values on edges of the potentials' shortest path tree.
+        return max(0.0, graph.Matrix[from][to] + _potential[from] - _potential[to]);
+    }
+
+    /// <summary>
+    /// Dijkstra on reduced costs from the source, or to it on reversed edges.
+    /// </summary>
+    vector<double> _Dijkstra(const Graph& graph, int source, bool reversed) const
+    {
+        vector<double> distance(_verticesNumber, UNREACHED);
+        priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> queue;
+        distance[source] = 0;
+        queue.push({ 0.0, source });
+
+        while (!queue.empty())
+        {
+            double d = queue.top().first;
+            int at = queue.top().second;
+            queue.pop();
+            if (d > distance[at])
+            {
+                continue;
+            }
+
+            for (int other = 0; other < _verticesNumber; other++)
+            {
+                int from = reversed ? other : at;
+                int to = reversed ? at : other;
+                if (other == at || graph.Matrix[from][to] == INF) // Edge not exists
+                {
+                    continue;
+                }
+
+                double candidate = d + _ReducedCost(graph, from, to);
+                if (candidate < distance[other])
+                {
+                    distance[other] = candidate;
+                    queue.push({ candidate, other });
+                }
+            }
+        }
+
+        return distance;
+    }
+
+    /// <summary>
+    /// Lower bound of the reduced distance v -> finish by the triangle inequality over all landmarks.
+    /// </summary>
+    double _Heuristic(int v, int finish) const
+    {
+        double bound = 0;
+        for (size_t i = 0; i < _landmarks.size(); i++)
+        {
+            const vector<double>& from = _fromLandmark[i];
+            const vector<double>& to = _toLandmark[i];
+            if (from[finish] != UNREACHED && from[v] != UNREACHED)
+            {
+                bound = max(bound, from[finish] - from[v]);
+            }
+            if (to[v] != UNREACHED && to[finish] != UNREACHED)
+            {
+                bound = max(bound, to[v] - to[finish]);
+            }
+        }
+        return bound;
+    }
+};
+
+#endif
@@ -3,297 +3,34 @@
 // See LICENSE file in the repo.
 
 #include <iostream>
-#include <queue>
-#include <list>
 #include <iomanip>
-#include "pathFindingBase.h";
+#include <cstdio>
+#include "pathFindingBase.h"
+#include "bellmanFordAlgorithm.h"
+#include "externalMemoryBellmanFord.h"
+#include "compressedGraph.h"
+#include "solverCheckpoint.h"
+#include "parallelBellmanFord.h"
+#include "graphGenerator.h"
+#include "solverValidation.h"
+#include "arbitrageMonitor.h"
+#include "edgeSensitivity.h"
+#include "ratioCycle.h"
+#include "constrainedPathFinder.h"
+#include "paretoPaths.h"
+#include "landmarkPathFinder.h"
+#include "contractionHierarchy.h"
+#include "hierarchicalGraph.h"
+#include "cyclePruning.h"
+#include "topKScreen.h"
+#include "quantizedScreen.h"
+#include "circuitEnumerator.h"
+#include "beamCycleSearch.h"
+#include "labelCorrectingSolver.h"
+#include "graphLoader.h"
 
 #define NDEBUG
 
-/// <summary>
-/// Bellman-Ford algorithm allows to find path between 2 nodes that:
-/// - Contain negative weights
-/// - Are not part of negative cycles (i.e. graph do not contain negative cycle).
-/// 
-/// Method of this class implement various algorithms to check if graph contains negative cycle and if NOT: finds path between 2 nodes by Bellman-Ford algorithm.
-/// </summary>
-class BellmanFordAlgorithm
-{
-public:
-    vector<double> _shortestPath;
-    vector<int> _previousVertex;
-    bool _solved = false;
-
-    /// <summary>
-    /// Checks if graph contains negative cycle and if NOT: finds path between 2 nodes by Bellman-Ford algorithm.
-    /// https://www.youtube.com/watch?v=24HziTZ8_xo
-    /// </summary>
-    bool ContainsNegativeCycles(Graph& graph, int start)
-    {
-        int verticesNumber = graph.Nodes.size();
-
-        _shortestPath.resize(verticesNumber, INF);
-        _previousVertex.resize(verticesNumber, -1);
-
-        _shortestPath[start] = 0;
-
-        bool updated = false;
-        // For each vertex, apply relaxation for all the edges V - 1 times.
-        // It's important that we should be able to find optimal solution for not more than V - 1 relaxation steps.
-        for (int k = 0; k < verticesNumber - 1; k++)
-        {
-            updated = false;
-            for (int from = 0; from < verticesNumber; from++)
-            {
-                for (int to = 0; to < verticesNumber; to++)
-                {
-                    if (_shortestPath[to] > _shortestPath[from] + graph.Matrix[from][to])
-                    {
-                        _shortestPath[to] = _shortestPath[from] + graph.Matrix[from][to];
-                        _previousVertex[to] = from;
-                        updated = true;
-                    }
-                }
-            }
-            if (!updated) // No changes in paths, means we can finish now.
-                break;
-        }
-
-        // Run one more relaxation step to detect which nodes are part of a negative cycle. 
-        // A negative cycle has occurred if we can find a better path beyond the optimal solution.
-        if (updated)
-        {
-            for (int from = 0; from < verticesNumber; from++)
-            {
-                for (int to = 0; to < verticesNumber; to++)
-                {
-                    if (_shortestPath[to] > _shortestPath[from] + graph.Matrix[from][to])
-                    {
-                        return true;
-                    }
-                }
-            }
-        }
-
-        _solved = true;
-
-        return false;
-    }
-
-    /// <summary>
-    /// Checks if graph contains negative cycle and if NOT: finds path between 2 nodes by Bellman-Ford algorithm.
-    /// </summary>
-    bool ContainsNegativeCycles_Sedgewick(Graph& graph, int start)
-    {
-        int n = graph.Nodes.size(); // V
-
-        _shortestPath.resize(n, INF);
-        _previousVertex.resize(n, -1);
-
-        _shortestPath[start] = 0;
-
-        bool updated = false;
-        for (size_t i = 0; i < n; ++i)
-        {
-            updated = false;
-            for (size_t from = 0; from < n; ++from)
-            {
-                for (size_t to = 0; to < n; ++to)
-                {
-                    if (from != start && _previousVertex[from] == -1)
-                        continue;
-
-                    if (graph.Matrix[from][to] == INF) // Edge not exists
-                    {
-                        continue;
-                    }
-
-                    int new_distance = _shortestPath[from] + graph.Matrix[from][to];
-                    if (_shortestPath[to] > new_distance)
-                    {
-                        _shortestPath[to] = new_distance;
-                        _previousVertex[to] = from;
-                        updated = true;
-                    }
-                }
-            }
-
-            if (i == n - 1 && updated)
-            {
-                return true; // Found negative cycle.
-            }
-        }
-
-        _solved = true;
-
-        return false;
-    }
-
-    /// <summary>
-    /// Implementation of Sedgewick Fifo algorithm for finding path in the graph with negatie weights (but not negative cycles).
-    /// Do not contain protection against cycles.
-    /// </summary>
-    void FindPathOnly(Graph& graph, int start)
-    {
-        int n = graph.Nodes.size(); // V
-
-        _shortestPath.resize(n, INF);
-        _previousVertex.resize(n, -1);
-
-        _shortestPath[start] = 0;
-
-        int z = 0;
-
-        queue<int> q;
-        q.push(start);
-        q.push(n);
-
-        while (!q.empty())
-        {
-            int from = -1;
-            while ((from = _QueueGet(q)) == n)
-            {
-                if (z++ > n)
-                {
-                    _solved = true;
-                    return;
-                }
-                q.push(n);
-            }
-
-            for (size_t to = 0; to < graph.Nodes.size(); ++to)
-            {
-                if (graph.Matrix[from][to] == INF) // Edge not exists
-                {
-                    continue;
-                }
-
-                double new_distance = _shortestPath[from] + graph.Matrix[from][to];
-
-                if (_shortestPath[to] > new_distance)
-                {
-                    _shortestPath[to] = new_distance;
-                    q.push(to);
-                    _previousVertex[to] = from;
-                }
-            }
-        }
-    }
-
-    /// <summary>
-    /// Whilliam's Fiset implementation of the Bellman-Ford algorithm:
-    /// https://github.com/williamfiset/Algorithms/blob/master/src/main/java/com/williamfiset/algorithms/graphtheory/BellmanFordAdjacencyMatrix.java
-    /// https://github.com/williamfiset/Algorithms/blob/master/src/main/java/com/williamfiset/algorithms/graphtheory/BellmanFordEdgeList.java
-    /// 
-    /// Not only checks if graph contains negative cycle, but also points nodes that are part of the cycle.
-    /// </summary>
-    bool FindPathsAndNegativeCycles(Graph& graph, int start)
-    {
-        int verticesNumber = graph.Nodes.size();
-
-        _shortestPath.resize(verticesNumber, INF);
-        _previousVertex.resize(verticesNumber, -1);
-
-        _shortestPath[start] = 0;
-
-        // For each vertex, apply relaxation for all the edges to find PATH (if there are no negative cycles).
-        for (int k = 0; k < verticesNumber - 1; k++)
-        {
-            for (int from = 0; from < verticesNumber; from++)
-            {
-                for (int to = 0; to < verticesNumber; to++)
-                {
-                    if (graph.Matrix[from][to] == INF) // Edge not exists
-                    {
-                        continue;
-                    }
-
-                    if (_shortestPath[to] > _shortestPath[from] + graph.Matrix[from][to])
-                    {
-                        _shortestPath[to] = _shortestPath[from] + graph.Matrix[from][to];
-                        _previousVertex[to] = from;
-                    }
-                }
-            }
-        }
-
-        bool negativeCycles = false;
-
-        // Run algorithm a second time to DETECT which nodes are part
-        // of a negative cycle. A negative cycle has occurred if we
-        // can find a better path beyond the optimal solution.
-        for (int k = 0; k < verticesNumber - 1; k++)
-        {
-            for (int from = 0; from < verticesNumber; from++)
-            {
-                for (int to = 0; to < verticesNumber; to++)
-                {
-                    if (graph.Matrix[from][to] == INF) // Edge not exists
-                    {
-                        continue;
-                    }
-
-                    if (_shortestPath[to] > _shortestPath[from] + graph.Matrix[from][to])
-                    {
-                        _shortestPath[to] = NEG_INF;
-                        _previousVertex[to] = -2;
-                        negativeCycles = true;
-                    }
-                }
-            }
-        }
-
-        _solved = true;
-
-        return negativeCycles;
-    }
-    
-    vector<int> ReconstructShortestPath(Graph& graph, int start, int finish)
-    {
-        if (_solved)
-        {
-            list<int> list;
-            if (_shortestPath[finish] == NEG_INF)
-            {
-                cout << "Path from " << start << " to " << finish << " is : Infinite number of shortest paths (negative cycle)." << endl;
-                return {};
-            }
-
-            for (int at = finish; _previousVertex[at] != -1 && _previousVertex[at] != -2; at = _previousVertex[at])
-            {
-                list.push_back(at);
-            }
-            list.push_back(start);
-
-            std::vector<int> path(list.begin(), list.end());
-            reverse(path.begin(), path.end());
-
-            cout << "Path from " << start << " to " << finish << " is : ";
-            for (int i = 0; i < path.size(); i++)
-            {
-                cout << path[i] << "(" << graph.Nodes[path[i]].Name << ") ";
-            }
-            cout << endl;
-
-            return path;
-        }
-        else
-        {
-            cout << "Not solved." << endl;
-        }
-
-        return {};
-    }
-
-private:
-    int _QueueGet(queue<int>& queue)
-    {
-        int v = queue.front();
-        queue.pop();
-        return v;
-    }
-};
-
 void runSimple(Graph& graph, int from)
 {
     cout << "///////Simplest alg////////////////////////////////" << endl;
@@ -347,6 +84,181 @@ void runSedgewickFifo(Graph& graph, int from)
     }
 }
 
+void runExternalMemory(Graph& graph, int from)
+{
+    cout << "///////External memory (edges streamed from file)////////////////////////////" << endl;
+    const string fileName = "graph-edges.bin";
+    ExternalMemoryBellmanFord algo5(16); // Tiny blocks (in bytes) to exercise block boundaries on small graphs.
+    ExternalMemoryBellmanFord::WriteEdgeFile(graph, fileName);
+    if (algo5.FindPathsAndNegativeCycles(fileName, graph.Nodes.size(), from))
+    {
+        cout << "Graph contains negative cycle." << endl;
+    }
+    for (int to = 0; to < (int)graph.Nodes.size(); to++)
+    {
+        algo5.ReconstructShortestPath(graph, from, to);
+    }
+    remove(fileName.c_str());
+}
+
+void runCompressed(Graph& graph, int from)
+{
+    cout << "///////Compressed CSR (delta + varint targets)////////////////////////////" << endl;
+    CompressedGraph compressed;
+    compressed.Build(graph);
+    CompressedBellmanFord algo6;
+    if (algo6.FindPathsAndNegativeCycles(compressed, from))
+    {
+        cout << "Graph contains negative cycle." << endl;
+    }
+    for (int to = 0; to < (int)graph.Nodes.size(); to++)
+    {
+        algo6.ReconstructShortestPath(graph, from, to);
+    }
+}
+
+void runParallel(Graph& graph, int from, ParallelBellmanFord::Mode mode)
+{
+    cout << "///////Parallel " << (mode == ParallelBellmanFord::Mode::Deterministic ? "deterministic" : "fast") << "////////////////////////////" << endl;
+    ParallelBellmanFord algo7(mode, 2);
+    if (algo7.FindPathsAndNegativeCycles(graph, from))
+    {
+        cout << "Graph contains negative cycle." << endl;
+    }
+    for (int to = 0; to < (int)graph.Nodes.size(); to++)
+    {
+        algo7.ReconstructShortestPath(graph, from, to);
+    }
+}
+
+void runCheckpoint(Graph& graph, int from)
+{
+    cout << "///////Checkpoint and restore////////////////////////////" << endl;
+    const string fileName = "solver-checkpoint.bin";
+    const uint64_t snapshotVersion = 1;
+    BellmanFordAlgorithm solved;
+    solved.FindPathsAndNegativeCycles(graph, from);
+    SolverCheckpoint::Save(solved, snapshotVersion, fileName);
+
+    BellmanFordAlgorithm restored;
+    SolverCheckpoint::Load(restored, snapshotVersion + 1, fileName); // Stale snapshot: rejected.
+    if (SolverCheckpoint::Load(restored, snapshotVersion, fileName))
+    {
+        for (int to = 0; to < (int)graph.Nodes.size(); to++)
+        {
+            restored.ReconstructShortestPath(graph, from, to);
+        }
+    }
+    remove(fileName.c_str());
+}
+
+void runAnchoredCycle(Graph& graph, int home)
+{
+    cout << "///////Best negative cycle through " << graph.Nodes[home].Name << "////////////////////////////" << endl;
+    BellmanFordAlgorithm algo8;
+    vector<int> cycle = algo8.FindNegativeCycleThrough(graph, home);
+    if (cycle.empty())
+    {
+        cout << "No negative cycle through " << graph.Nodes[home].Name << "." << endl;
+        return;
+    }
+    for (int v : cycle)
+    {
+        cout << v << "(" << graph.Nodes[v].Name << ") ";
+    }
+    cout << "weight " << BellmanFordAlgorithm::CycleWeight(graph, cycle) << endl;
+}
+
+void runRatioCycle(Graph& graph, const vector<vector<double>>& times)
+{
+    cout << "///////Minimum ratio cycle (" << (times.empty() ? "per leg" : "per time unit") << ")////////////////////////////" << endl;
+    MinimumRatioCycle ratioCycle;
+    vector<int> cycle = ratioCycle.Solve(graph, times);
+    if (cycle.empty())
+    {
+        cout << "No cycle." << endl;
+        return;
+    }
+    for (int v : cycle)
+    {
+        cout << v << "(" << graph.Nodes[v].Name << ") ";
+    }
+    cout << "ratio " << ratioCycle.BestRatio() << " found in " << ratioCycle.Steps() << " steps, " << ratioCycle.Passes() << " passes" << endl;
+}
+
+void runCircuits(Graph& graph, int maxLength)
+{
+    cout << "///////All negative circuits up to " << maxLength << " legs////////////////////////////" << endl;
+    CircuitEnumerator enumerator;
+    for (const Circuit& circuit : enumerator.Enumerate(graph, maxLength))
+    {
+        for (int v : circuit.Cycle)
+        {
+            cout << v << "(" << graph.Nodes[v].Name << ") ";
+        }
+        cout << "weight " << circuit.Weight << endl;
+    }
+}
+
+void runParetoPaths(Graph& graph, int from, int maxLegs)
+{
+    cout << "///////Pareto front of (cost, legs) up to " << maxLegs << " legs////////////////////////////" << endl;
+    ParetoPathFinder pareto;
+    pareto.Solve(graph, from, maxLegs);
+    for (int to = 0; to < (int)graph.Nodes.size(); to++)
+    {
+        cout << "To " << to << "(" << graph.Nodes[to].Name << "):";
+        for (const ParetoPoint& point : pareto.Front(to))
+        {
+            cout << " [" << point.Legs << " legs, cost " << point.Cost << ":";
+            for (int v : pareto.Path(graph, to, point.Legs))
+            {
+                cout << " " << v;
+            }
+            cout << "]";
+        }
+        cout << endl;
+    }
+}
+
+void runLandmarks(Graph& graph, int landmarksNumber)
+{
+    cout << "///////A* with " << landmarksNumber << " landmarks (ALT)////////////////////////////" << endl;
+    LandmarkPathFinder landmarks;
+    if (!landmarks.Preprocess(graph, landmarksNumber))
+    {
+        cout << "Graph contains negative cycle." << endl;
+        return;
+    }
+    for (int to = 0; to < (int)graph.Nodes.size(); to++)
+    {
+        landmarks.FindPath(graph, 1, to);
+    }
+}
+
+void runContractionHierarchy(Graph& graph)
+{
+    cout << "///////Contraction hierarchy on reduced costs////////////////////////////" << endl;
+    ContractionHierarchy hierarchy;
+    if (!hierarchy.Build(graph))
+    {
+        cout << "Graph contains negative cycle." << endl;
+        return;
+    }
+    cout << "Hierarchy arcs: " << hierarchy.ArcsNumber() << ", levels: " << hierarchy.LevelsNumber() << endl;
+    for (int to = 0; to < (int)graph.Nodes.size(); to++)
+    {
+        hierarchy.FindPath(graph, 1, to);
+    }
+
+    // Tick: only weights change, so re-running customization is enough.
+    graph.Matrix[1][2] += 5.0;
+    hierarchy.Customize(graph);
+    hierarchy.FindPath(graph, 1, 2);
+    cout << "Cost after tick: " << hierarchy._pathCost << endl;
+    graph.Matrix[1][2] -= 5.0;
+}
+
 void runAllNoNegativeCyclesTests(Graph& graph, int from)
 {
     cout << "///////Simple graph without negative cycles////////////////////////////////////////////////" << endl;
@@ -368,6 +280,7 @@ void runAllNoNegativeCyclesTests(Graph& graph, int from)
     runDetectNegativeCycles(graph, from);
     runSedgewick(graph, from);
     runSedgewickFifo(graph, from);
+    runCheckpoint(graph, from);
     // Result:
     // Path from 0 to 0 is : 0(USD)
     // Path from 0 to 1 is : 0(USD) 2(YEN) 4(CNY) 1(CHF)
@@ -396,6 +309,10 @@ void runAllNoNegativeCyclesTests(Graph& graph, int from)
     runDetectNegativeCycles(graph, from);
     runSedgewick(graph, from);
     runSedgewickFifo(graph, from);
+    runExternalMemory(graph, from);
+    runCompressed(graph, from);
+    runParallel(graph, from, ParallelBellmanFord::Mode::Fast);
+    runParallel(graph, from, ParallelBellmanFord::Mode::Deterministic);
     // Result:
     // Path from 4 to 0 is : 4(CNY) 3(GBP) 0(USD)
     // Path from 4 to 1 is : 4(CNY) 3(GBP) 5(EUR) 1(CHF)
@@ -428,6 +345,10 @@ void runOnNegativeCycles(Graph& graph, int from)
                      { INF, INF, INF, INF,  INF, INF, INF, 0.0 } }; // YYY
     from = 0;
     runDetectNegativeCycles(graph, from);
+    runExternalMemory(graph, from);
+    runCompressed(graph, from);
+    runParallel(graph, from, ParallelBellmanFord::Mode::Fast);
+    runParallel(graph, from, ParallelBellmanFord::Mode::Deterministic);
     // Result:
     // Graph contains negative cycle.
     // Path from 0 to 0 is : 0(USD)
@@ -472,6 +393,32 @@ void runArbitrageTests(Graph& graph, int from)
     //    Path from 0 to 2 is: Infinite number of shortest paths (negative cycle).
     //    Path from 0 to 3 is: Infinite number of shortest paths (negative cycle).
     //    Path from 0 to 4 is: Infinite number of shortest paths (negative cycle).
+    runAnchoredCycle(graph, 3);
+    runAnchoredCycle(graph, 1);
+    // Result:
+    //    3(GBP) 0(USD) 4(CNY) 2(YEN) weight -0.005
+    //    1(CHF) 0(USD) 4(CNY) 2(YEN) weight -0.004
+
+    runRatioCycle(graph, {});
+    //               USD  CHF  YEN  GBP  CNY   (Latency of every conversion)
+    runRatioCycle(graph, { { 1.0, 1.0, 1.0, 1.0, 1.0 },
+                           { 1.0, 1.0, 1.0, 1.0, 1.0 },
+                           { 1.0, 1.0, 1.0, 5.0, 1.0 },
+                           { 1.0, 1.0, 1.0, 1.0, 1.0 },
+                           { 1.0, 1.0, 1.0, 1.0, 1.0 } });
+    // Result:
+    //    4(CNY) 2(YEN) 3(GBP) 0(USD) ratio -0.00125 (per leg)
+    //    4(CNY) 2(YEN) 0(USD) ratio -0.001 (slow YEN->GBP leg makes the shorter cycle better)
+
+    runCircuits(graph, 3);
+    // Result:
+    //    0(USD) 4(CNY) 2(YEN) weight -0.003
+    //    0(USD) 4(CNY) 1(CHF) weight -0.002
+    //    1(CHF) 4(CNY) 2(YEN) weight -0.002
+    //    0(USD) 2(YEN) 3(GBP) weight -0.002
+    //    0(USD) 4(CNY) 3(GBP) weight -0.002
+    //    0(USD) 2(YEN) 1(CHF) weight -0.001
+    //    1(CHF) 2(YEN) weight -0.001
 
     cout << "///////Arbitrage simpler test cases (my modifications)////////////////////////////////////////////" << endl;
     graph.Clear();
@@ -534,6 +481,45 @@ void runArbitrageTests(Graph& graph, int from)
     // Path from 0 to 3 is : 0(USD) 2(YEN) 3(GBP)
     // Path from 0 to 4 is : 0(USD) 2(YEN) 4(CNY)
 
+    // Latency of every conversion (ms):
+    //                  USD   CHF   YEN   GBP   CNY
+    graph.Latency = { { 0.0,  2.0,  5.0,  1.0,  2.0 },   // USD
+                      { 2.0,  0.0,  1.0,  2.0,  2.0 },   // CHF
+                      { 5.0,  1.0,  0.0,  4.0,  3.0 },   // YEN
+                      { 1.0,  2.0,  4.0,  0.0,  1.0 },   // GBP
+                      { 2.0,  2.0,  3.0,  1.0,  0.0 } }; // CNY
+    runParetoPaths(graph, from, 4);
+    // Result:
+    // To 1(CHF): [1 legs, cost 0.49: 0 1] [2 legs, cost 0.489: 0 2 1]
+    // To 3(GBP): [1 legs, cost 0.7: 0 3] [2 legs, cost 0.508: 0 2 3]
+
+    ConstrainedPathFinder constrained;
+    constrained.FindPath(graph, 0, 3, 10.0);
+    constrained.FindPath(graph, 0, 3, 8.0);
+    constrained.FindPath(graph, 0, 3, 0.5);
+    // Result:
+    // Path from 0 to 3 within latency 10 is : 0(USD) 2(YEN) 3(GBP) cost 0.508, latency 9
+    // Path from 0 to 3 within latency 8 is : 0(USD) 1(CHF) 2(YEN) 3(GBP) cost 0.509, latency 7
+    // Path from 0 to 3 is : Not reachable within latency 0.5.
+
+    runLandmarks(graph, 2);
+    // Result:
+    // Path from 1 to 0 is : 1(CHF) 0(USD)
+    // Path from 1 to 1 is : 1(CHF)
+    // Path from 1 to 2 is : 1(CHF) 2(YEN)
+    // Path from 1 to 3 is : 1(CHF) 2(YEN) 3(GBP)
+    // Path from 1 to 4 is : 1(CHF) 2(YEN) 4(CNY)
+    runContractionHierarchy(graph);
+    // Result:
+    // Hierarchy arcs: 10, levels: 5
+    // Path from 1 to 0 is : 1(CHF) 0(USD)
+    // Path from 1 to 1 is : 1(CHF)
+    // Path from 1 to 2 is : 1(CHF) 2(YEN)
+    // Path from 1 to 3 is : 1(CHF) 2(YEN) 3(GBP)
+    // Path from 1 to 4 is : 1(CHF) 2(YEN) 4(CNY)
+    // Path from 1 to 2 is : 1(CHF) 0(USD) 2(YEN)
+    // Cost after tick: -0.891
+
     cout << "///////VERY REAL EXAMPLES////////////////////////////////////////////" << endl;
     graph.Clear();
     graph.Nodes.push_back({ "USD" }); // 1 (Index = 0)
@@ -565,8 +551,561 @@ void runArbitrageTests(Graph& graph, int from)
     // Path from 0 to 2 is : 0(USD) 2(YEN)
 }
 
+void printSignals(Graph& graph, int tick, const vector<CycleSignal>& signals)
+{
+    cout << "Tick " << tick << ": ";
+    if (signals.empty())
+    {
+        cout << "no arbitrage";
+    }
+    for (const CycleSignal& signal : signals)
+    {
+        for (int v : signal.Cycle)
+        {
+            cout << v << "(" << graph.Nodes[v].Name << ") ";
+        }
+        cout << "weight " << signal.Weight << (signal.FromWatchlist ? " [watchlist]; " : " [full search]; ");
+    }
+    cout << endl;
+}
+
+void runArbitrageMonitor(Graph& graph, int from)
+{
+    cout << "///////Arbitrage monitor with cycle watchlist////////////////////////////////////////////" << endl;
+    graph.Clear();
+    graph.Nodes.push_back({ "USD" }); // 1 (Index = 0)
+    graph.Nodes.push_back({ "CHF" });
+    graph.Nodes.push_back({ "YEN" }); // 3 (Index = 2)
+
+    // LogE(x) table: USD       CHF      YEN
+    graph.Matrix = {{ 0.0,      0.1,     -5.01 },   // USD
+                    { -0.09,    0.0,     -5.1  },   // CHF
+                    { 5.0,      5.09,    0.0   } }; // YEN
+    from = 0;
+    ArbitrageMonitor monitor(graph, from);
+    printSignals(graph, 1, monitor.OnTick({}));                       // Full search finds the cycle.
+    printSignals(graph, 2, monitor.OnTick({ { 0, 1, 0.11 } }));       // Edge not on the cycle: watchlist only.
+    printSignals(graph, 3, monitor.OnTick({ { 2, 0, 5.005 } }));      // Cycle is still profitable, but less.
+    printSignals(graph, 4, monitor.OnTick({ { 2, 0, 5.02 } }));       // Cycle closed: full search fallback.
+    cout << "Full searches: " << monitor.FullSearches() << " of 4 ticks." << endl;
+    // Result:
+    // Tick 1: 0(USD) 2(YEN) weight -0.01 [full search];
+    // Tick 2: 0(USD) 2(YEN) weight -0.01 [watchlist];
+    // Tick 3: 0(USD) 2(YEN) weight -0.005 [watchlist];
+    // Tick 4: 1(CHF) 2(YEN) weight -0.01 [full search];
+
+    cout << "///////Arbitrage monitor skipping no-op ticks////////////////////////////////////////////" << endl;
+    graph.Clear();
+    graph.Nodes.push_back({ "USD" }); // 1 (Index = 0)
+    graph.Nodes.push_back({ "CHF" });
+    graph.Nodes.push_back({ "YEN" });
+    graph.Nodes.push_back({ "GBP" });
+    graph.Nodes.push_back({ "CNY" }); // 5  (Index = 4)
+    // LogE(x) table:  USD      CHF      YEN     GBP     CNY
+    graph.Matrix = { { 0.0,    0.490, -0.402, 0.7,  0.413 },   // USD
+                     { -0.489, 0.0,   -0.891, 0.89, 0.360 },   // CHF
+                     { 0.403,  0.891,  0.0,   0.91, 0.581 },   // YEN
+                     { 0.340,  0.405,  0.607, 0.0,  0.72 },   // GBP
+                     { 0.403,  0.350,  0.571, 0.71, 0.0 } };   // CNY
+    from = 0;
+    ArbitrageMonitor quiet(graph, from);
+    printSignals(graph, 1, quiet.OnTick({}));                         // Full search: no cycle, solution kept.
+    printSignals(graph, 2, quiet.OnTick({ { 3, 4, 0.75 } }));         // Not a tree edge, reduced cost stays positive: skipped.
+    printSignals(graph, 3, quiet.OnTick({ { 0, 1, 0.495 } }));        // Not a tree edge, reduced cost stays positive: skipped.
+    printSignals(graph, 4, quiet.OnTick({ { 0, 2, -0.40 } }));        // Tree edge changed: solved again.
+    printSignals(graph, 5, quiet.OnTick({ { 1, 0, -0.495 } }));       // Reduced cost becomes negative: solved again, cycle found.
+    cout << "Full searches: " << quiet.FullSearches() << ", skipped: " << quiet.SkippedSolves() << " of 5 ticks." << endl;
+    // Result:
+    // Tick 1..4: no arbitrage
+    // Tick 5: 0(USD) 2(YEN) 1(CHF) weight -0.004 [full search];
+    // Full searches: 3, skipped: 2 of 5 ticks.
+}
+
+void runEdgeSensitivity(Graph& graph, int from)
+{
+    cout << "///////Edge sensitivity ranges////////////////////////////////////////////" << endl;
+    graph.Clear();
+    graph.Nodes.push_back({ "USD" }); // 1 (Index = 0)
+    graph.Nodes.push_back({ "CHF" });
+    graph.Nodes.push_back({ "YEN" });
+    graph.Nodes.push_back({ "GBP" });
+    graph.Nodes.push_back({ "CNY" }); // 5  (Index = 4)
+    // LogE(x) table:  USD      CHF      YEN     GBP     CNY
+    graph.Matrix = { { 0.0,    0.490, -0.402, 0.7,  0.413 },   // USD
+                     { -0.489, 0.0,   -0.891, 0.89, 0.360 },   // CHF
+                     { 0.403,  0.891,  0.0,   0.91, 0.581 },   // YEN
+                     { 0.340,  0.405,  0.607, 0.0,  0.72 },   // GBP
+                     { 0.403,  0.350,  0.571, 0.71, 0.0 } };   // CNY
+    from = 0;
+    BellmanFordAlgorithm algo;
+    algo.FindPathsAndNegativeCycles(graph, from);
+    EdgeSensitivity sensitivity;
+    if (!sensitivity.Compute(graph, algo))
+    {
+        cout << "No solution without negative cycles." << endl;
+        return;
+    }
+
+    for (int to = 1; to < (int)graph.Nodes.size(); to++)
+    {
+        cout << graph.Nodes[from].Name << "->" << graph.Nodes[to].Name << " weight " << graph.Matrix[from][to]
+             << " stays optimal in [" << sensitivity.Lower(from, to) << ", " << sensitivity.Upper(from, to) << "]" << endl;
+    }
+    cout << "CHF->USD is " << sensitivity.Slack(graph, 1, 0) << " away from arbitrage." << endl;
+    // Result:
+    // USD->CHF weight 0.49 stays optimal in [0.489, inf]
+    // USD->YEN weight -0.402 stays optimal in [-0.402, -0.401]
+    // USD->GBP weight 0.7 stays optimal in [0.508, inf]
+    // USD->CNY weight 0.413 stays optimal in [0.179, inf]
+    // CHF->USD is 0 away from arbitrage. (USD->YEN->CHF->USD is a zero weight cycle.)
+}
+
+void runCyclePruning(Graph& graph)
+{
+    cout << "///////Pruning vertices which can not be on a cycle////////////////////////////" << endl;
+    GraphGenerator::RandomRates(graph, 2000, 11, 0.001, 0.005, 0.0006);
+    CyclePruning pruning;
+    pruning.Compute(graph);
+    cout << "Vertices: " << graph.Nodes.size() << ", left after pruning: " << pruning.ActiveNumber << endl;
+
+    BellmanFordAlgorithm algo;
+    vector<int> cycle = algo.FindAnyNegativeCycle(graph, pruning.Active);
+    cout << "Cycle: ";
+    for (int v : cycle)
+    {
+        cout << v << "(" << graph.Nodes[v].Name << ") ";
+    }
+    cout << "weight " << BellmanFordAlgorithm::CycleWeight(graph, cycle) << endl;
+    // Result:
+    // Vertices: 2000, left after pruning: 244
+    // Cycle: 437(C437) 1750(C1750) 1945(C1945) weight -0.00119859
+}
+
+void runTopKScreen(Graph& graph)
+{
+    cout << "///////Top-K out-edges screening graph////////////////////////////" << endl;
+    GraphGenerator::RandomRates(graph, 300, 21, 0.001, 0.01);
+    TopKScreen screen(8);
+    screen.Build(graph);
+    cout << "Screen edges: " << screen.ScreenEdges() << " of " << graph.Nodes.size() * (graph.Nodes.size() - 1) << endl;
+
+    for (int tick = 1; tick <= 3; tick++)
+    {
+        vector<int> cycle = screen.FindNegativeCycle(graph);
+        cout << "Tick " << tick << ": ";
+        for (int v : cycle)
+        {
+            cout << v << "(" << graph.Nodes[v].Name << ") ";
+        }
+        cout << "weight " << BellmanFordAlgorithm::CycleWeight(graph, cycle) << endl;
+
+        // Close the cycle found: its first edge gets a wide spread.
+        if (!cycle.empty())
+        {
+            screen.OnTick(graph, { { cycle[0], cycle[1], graph.Matrix[cycle[0]][cycle[1]] + 0.05 } });
+        }
+    }
+    cout << "Escalations to the full graph: " << screen.Escalations() << " of " << screen.Searches() << " searches." << endl;
+    // Result:
+    // Screen edges: 2400 of 89700
+    // Tick 1: 263(C263) 280(C280) weight -0.00674412
+    // Tick 2: 280(C280) 297(C297) 209(C209) weight -0.00260023
+    // Tick 3: 280(C280) 234(C234) 297(C297) 209(C209) weight -0.00891657
+    // Escalations to the full graph: 0 of 3 searches.
+}
+
+void runQuantizedScreen(Graph& graph)
+{
+    cout << "///////Two stage detection: int16 screen, then exact////////////////////////////" << endl;
+    GraphGenerator::RandomRates(graph, 300, 5, 0.001, 0.0);
+    QuantizedScreen screen;
+    screen.Build(graph);
+    double closing = graph.Matrix[1][0];
+
+    vector<vector<EdgeUpdate>> ticks = {
+        {},                                                               // No arbitrage: proved by the screen.
+        { { 1, 0, -graph.Matrix[0][1] - 0.01 } },                         // 0 -> 1 -> 0 pays 1%.
+        { { 1, 0, closing } } };                                          // Back to normal.
+    for (size_t tick = 0; tick < ticks.size(); tick++)
+    {
+        screen.OnTick(graph, ticks[tick]);
+        vector<int> cycle = screen.FindNegativeCycle(graph);
+        cout << "Tick " << tick + 1 << ": ";
+        for (int v : cycle)
+        {
+            cout << v << "(" << graph.Nodes[v].Name << ") ";
+        }
+        cout << (cycle.empty() ? "no arbitrage" : "") << endl;
+    }
+    cout << "Proved by the screen: " << screen.Proved() << ", exact solves: " << screen.ExactSolves() << endl;
+    // Result:
+    // Tick 1: no arbitrage
+    // Tick 2: 1(C1) 0(C0)
+    // Tick 3: no arbitrage
+    // Proved by the screen: 2, exact solves: 1
+}
+
+void runBeamSearch(Graph& graph)
+{
+    cout << "///////Beam search for cycles, verified exactly////////////////////////////" << endl;
+    GraphGenerator::RandomRates(graph, 400, 7, 0.001, 0.0012);
+    BeamCycleSearch beam(8, 4);
+    vector<Circuit> circuits = beam.Find(graph);
+    cout << "Candidates: " << beam.Candidates() << ", verified cycles: " << circuits.size() << endl;
+    for (size_t i = 0; i < min((size_t)3, circuits.size()); i++)
+    {
+        for (int v : circuits[i].Cycle)
+        {
+            cout << v << "(" << graph.Nodes[v].Name << ") ";
+        }
+        cout << "weight " << circuits[i].Weight << endl;
+    }
+    // Result:
+    // Candidates: 134, verified cycles: 134
+    // 149(C149) 199(C199) 381(C381) weight -0.000428597
+    // 46(C46) 388(C388) 149(C149) 385(C385) weight -0.000414143
+    // 46(C46) 50(C50) weight -0.00038443
+}
+
+void runHierarchicalGraph(Graph& graph)
+{
+    cout << "///////Currency to venue graph: coarse then refine////////////////////////////" << endl;
+    const int currenciesNumber = 40;
+    const int venuesNumber = 20;
+    vector<int> currencyOf;
+    GraphGenerator::RandomVenues(graph, currencyOf, currenciesNumber, venuesNumber, 7, 0.001, 0.0015, 0.0002);
+    vector<string> currencyNames;
+    for (int c = 0; c < currenciesNumber; c++)
+    {
+        currencyNames.push_back("C" + to_string(c));
+    }
+
+    HierarchicalGraph hierarchy;
+    hierarchy.Build(graph, currencyOf, currencyNames);
+    vector<int> cycle = hierarchy.FindNegativeCycle(graph);
+    cout << "Fine vertices: " << graph.Nodes.size() << ", solved: " << hierarchy.FineVerticesSolved()
+         << ", refinements: " << hierarchy.Refinements() << endl;
+    cout << "Cycle: ";
+    for (int v : cycle)
+    {
+        cout << v << "(" << graph.Nodes[v].Name << ") ";
+    }
+    cout << "weight " << BellmanFordAlgorithm::CycleWeight(graph, cycle) << endl;
+    // Result:
+    // Fine vertices: 800, solved: 40, refinements: 1
+    // Cycle: 238(C38@V5) 239(C39@V5) weight -0.000723038
+}
+
+template <class QueuePolicy>
+void runQueuePolicy(Graph& graph, const string& name)
+{
+    LabelCorrectingSolver<QueuePolicy> algo;
+    bool negativeCycle = algo.FindPathsAndNegativeCycles(graph, 0);
+    cout << "    " << left << setw(12) << name << right << setw(10) << algo.Scans() << " scans" << setw(10) << algo.Relaxations()
+         << " relaxations" << (negativeCycle ? "   negative cycle" : "") << endl;
+}
+
+void runQueuePolicies(Graph& graph)
+{
+    cout << "///////Label-correcting queue disciplines: work per graph family////////////////////////////" << endl;
+    vector<pair<string, function<void(Graph&)>>> families = {
+        { "dense, no arbitrage", [](Graph& g) { GraphGenerator::RandomRates(g, 300, 1, 0.001, 0.0); } },
+        { "sparse, no arbitrage", [](Graph& g) { GraphGenerator::RandomRates(g, 1000, 3, 0.001, 0.0, 0.01); } },
+        { "venues, no arbitrage", [](Graph& g) { vector<int> currencyOf; GraphGenerator::RandomVenues(g, currencyOf, 40, 20, 7, 0.001, 0.0, 0.0002); } },
+        { "dense, with arbitrage", [](Graph& g) { GraphGenerator::RandomRates(g, 300, 2, 0.001, 0.01); } },
+        { "negative chain", [](Graph& g) { GraphGenerator::NegativeChain(g, 300, false); } },
+        { "negative chain, closed", [](Graph& g) { GraphGenerator::NegativeChain(g, 300, true); } },
+        { "grid with planted cycle", [](Graph& g) { GraphGenerator::GridWithCycle(g, 15, 20, 1, true); } },
+        { "SPFA killer", [](Graph& g) { GraphGenerator::SpfaKiller(g, 100, 4, 1); } } };
+
+    for (auto& family : families)
+    {
+        family.second(graph);
+        cout << family.first << " (" << graph.Nodes.size() << " vertices):" << endl;
+        runQueuePolicy<FifoPolicy>(graph, "FIFO");
+        runQueuePolicy<SmallLabelFirstPolicy>(graph, "SLF");
+        runQueuePolicy<LargeLabelLastPolicy>(graph, "LLL");
+        runQueuePolicy<SmallLabelFirstLargeLabelLastPolicy>(graph, "SLF + LLL");
+    }
+    // Result:
+    // dense, no arbitrage (300 vertices):
+    //     FIFO               300 scans       299 relaxations
+    //     SLF                300 scans       299 relaxations
+    //     LLL                300 scans       299 relaxations
+    //     SLF + LLL          300 scans       299 relaxations
+    // sparse, no arbitrage (1000 vertices):
+    //     FIFO              1000 scans      1176 relaxations
+    //     SLF               1884 scans      4274 relaxations
+    //     LLL               1772 scans      2094 relaxations
+    //     SLF + LLL         2499 scans      4688 relaxations
+    // venues, no arbitrage (800 vertices):
+    //     FIFO               800 scans       799 relaxations
+    //     SLF                856 scans      2046 relaxations
+    //     LLL                800 scans      2091 relaxations
+    //     SLF + LLL         1000 scans      2769 relaxations
+    // dense, with arbitrage (300 vertices):
+    //     FIFO               549 scans     77246 relaxations   negative cycle
+    //     SLF                449 scans     73903 relaxations   negative cycle
+    //     LLL                540 scans     77020 relaxations   negative cycle
+    //     SLF + LLL          449 scans     73903 relaxations   negative cycle
+    // negative chain (300 vertices):
+    //     FIFO             44851 scans     44850 relaxations
+    //     SLF              44257 scans     44258 relaxations
+    //     LLL                300 scans       597 relaxations
+    //     SLF + LLL          300 scans       597 relaxations
+    // negative chain, closed (300 vertices):
+    //     FIFO             44851 scans     44851 relaxations   negative cycle
+    //     SLF              44257 scans     44259 relaxations   negative cycle
+    //     LLL                300 scans       598 relaxations   negative cycle
+    //     SLF + LLL          300 scans       598 relaxations   negative cycle
+    // grid with planted cycle (300 vertices):
+    //     FIFO              5124 scans      5396 relaxations   negative cycle
+    //     SLF               4153 scans      4671 relaxations   negative cycle
+    //     LLL               3544 scans      4343 relaxations   negative cycle
+    //     SLF + LLL         2769 scans      3766 relaxations   negative cycle
+    // SPFA killer (400 vertices):
+    //     FIFO             10334 scans     12648 relaxations
+    //     SLF                819 scans      1231 relaxations
+    //     LLL                509 scans       818 relaxations
+    //     SLF + LLL          525 scans       867 relaxations
+}
+
+void runLoaders(Graph& graph)
+{
+    cout << "///////DIMACS and Matrix Market loaders, negative weight transformation////////////////////////////" << endl;
+    // Graph of the first test, with vertices 1-based.
+    const string dimacsName = "graph-sample.gr";
+    const string matrixMarketName = "graph-sample.mtx";
+    {
+        ofstream dimacs(dimacsName);
+        dimacs << "c Simple graph without negative cycles\np sp 5 9\n"
+               << "a 1 2 6\na 1 3 7\na 2 3 8\na 2 4 -4\na 2 5 5\na 3 4 9\na 3 5 -3\na 4 5 7\na 5 2 -2\n";
+        ofstream matrixMarket(matrixMarketName);
+        matrixMarket << "%%MatrixMarket matrix coordinate integer general\n% Same graph\n5 5 9\n"
+                     << "1 2 6\n1 3 7\n2 3 8\n2 4 -4\n2 5 5\n3 4 9\n3 5 -3\n4 5 7\n5 2 -2\n";
+    }
+
+    GraphLoader loader;
+    CompressedGraph dimacsGraph;
+    CompressedGraph matrixMarketGraph;
+    if (loader.LoadDimacs(dimacsName, dimacsGraph) && loader.LoadMatrixMarket(matrixMarketName, matrixMarketGraph))
+    {
+        cout << "DIMACS: " << dimacsGraph.VerticesNumber() << " vertices, " << dimacsGraph.EdgesNumber() << " edges; Matrix Market: "
+             << matrixMarketGraph.VerticesNumber() << " vertices, " << matrixMarketGraph.EdgesNumber() << " edges, "
+             << (dimacsGraph.Weights == matrixMarketGraph.Weights && dimacsGraph.Targets == matrixMarketGraph.Targets ? "same" : "different")
+             << " graphs" << endl;
+
+        // Potentials change weights of edges, but not shortest paths.
+        GraphLoader::Reweight(dimacsGraph, 1, 10.0);
+        dimacsGraph.Expand(graph);
+        CompressedBellmanFord algo;
+        algo.FindPathsAndNegativeCycles(dimacsGraph, 0);
+        for (int to = 0; to < dimacsGraph.VerticesNumber(); to++)
+        {
+            algo.ReconstructShortestPath(graph, 0, to);
+        }
+        // Result:
+        // DIMACS: 5 vertices, 9 edges; Matrix Market: 5 vertices, 9 edges, same graphs
+        // Path from 0 to 0 is : 0(1)
+        // Path from 0 to 1 is : 0(1) 2(3) 4(5) 1(2)
+        // Path from 0 to 2 is : 0(1) 2(3)
+        // Path from 0 to 3 is : 0(1) 2(3) 4(5) 1(2) 3(4)
+        // Path from 0 to 4 is : 0(1) 2(3) 4(5)
+    }
+    remove(dimacsName.c_str());
+    remove(matrixMarketName.c_str());
+}
+
+template <class QueuePolicy>
+void runDatasetPolicy(const CompressedGraph& compressed, const string& name)
+{
+    LabelCorrectingSolver<QueuePolicy> algo;
+    auto begin = chrono::high_resolution_clock::now();
+    bool negativeCycle = algo.FindPathsAndNegativeCycles(compressed, 0);
+    auto end = chrono::high_resolution_clock::now();
+    cout << "    " << left << setw(22) << name << right << chrono::duration<double, milli>(end - begin).count() << " ms, " << algo.Scans()
+         << " scans, negative cycle: " << (negativeCycle ? "yes" : "no") << endl;
+}
+
+/// <summary>
+/// Benchmark mode: graph-negative-cycles --benchmark <file.gr | file.mtx>...
+/// Loads every file, scales and reweights it to get negative edges and runs the solvers from vertex 1 (id 0).
+/// CompressedBellmanFord, the label-correcting solvers and ParallelBellmanFord work on CompressedGraph; solvers working on Graph
+/// need V^2 memory and run (and are cross-checked) only on small files.
+/// Returns the number of disagreements found by SolverValidation.
+/// </summary>
+int runDatasets(const vector<string>& fileNames)
+{
+    const int matrixLimit = 1000;
+    int failed = 0;
+    GraphLoader loader;
+    for (const string& fileName : fileNames)
+    {
+        CompressedGraph compressed;
+        auto begin = chrono::high_resolution_clock::now();
+        bool matrixMarket = fileName.size() >= 4 && fileName.compare(fileName.size() - 4, 4, ".mtx") == 0;
+        if (!(matrixMarket ? loader.LoadMatrixMarket(fileName, compressed) : loader.LoadDimacs(fileName, compressed)) ||
+            compressed.VerticesNumber() == 0)
+        {
+            continue;
+        }
+        auto end = chrono::high_resolution_clock::now();
+        cout << fileName << ": " << compressed.VerticesNumber() << " vertices, " << compressed.EdgesNumber() << " edges, loaded in "
+             << chrono::duration<double, milli>(end - begin).count() << " ms" << endl;
+
+        GraphLoader::Normalize(compressed);
+        GraphLoader::Reweight(compressed, 1, 1.0);
+
+        CompressedBellmanFord algo;
+        begin = chrono::high_resolution_clock::now();
+        bool negativeCycle = algo.FindPathsAndNegativeCycles(compressed, 0);
+        end = chrono::high_resolution_clock::now();
+        cout << "    " << left << setw(22) << "CompressedBellmanFord" << right << chrono::duration<double, milli>(end - begin).count()
+             << " ms, negative cycle: " << (negativeCycle ? "yes" : "no") << endl;
+
+        // Label-correcting solvers scan the CSR directly, so they run on files of any size.
+        runDatasetPolicy<FifoPolicy>(compressed, "FIFO");
+        runDatasetPolicy<SmallLabelFirstPolicy>(compressed, "SLF");
+        runDatasetPolicy<LargeLabelLastPolicy>(compressed, "LLL");
+        runDatasetPolicy<SmallLabelFirstLargeLabelLastPolicy>(compressed, "SLF + LLL");
+
+        ParallelBellmanFord parallel(ParallelBellmanFord::Mode::Deterministic);
+        begin = chrono::high_resolution_clock::now();
+        negativeCycle = parallel.FindPathsAndNegativeCycles(compressed, 0);
+        end = chrono::high_resolution_clock::now();
+        cout << "    " << left << setw(22) << "ParallelBellmanFord" << right << chrono::duration<double, milli>(end - begin).count()
+             << " ms, negative cycle: " << (negativeCycle ? "yes" : "no") << endl;
+
+        // The other engines need the adjacency matrix.
+        if (compressed.VerticesNumber() <= matrixLimit)
+        {
+            Graph graph;
+            compressed.Expand(graph);
+            SolverValidation validation;
+            failed += validation.Validate(graph, 0, fileName);
+        }
+    }
+    return failed;
+}
+
+void runCompressedFootprint(Graph& graph)
+{
+    cout << "///////Compressed CSR footprint and relaxation pass time////////////////////////////" << endl;
+    GraphGenerator::RandomRates(graph, 2000, 9, 0.001, 0.0, 0.01);
+    CompressedGraph compressed;
+    compressed.Build(graph);
+    int verticesNumber = compressed.VerticesNumber();
+    double edgesNumber = compressed.EdgesNumber();
+    cout << fixed << setprecision(2) << compressed.EdgesNumber() << " edges, bytes per edge: compressed " << compressed.MemoryBytes() / edgesNumber
+         << ", plain CSR " << (double)sizeof(int) + sizeof(double) << ", matrix " << 8.0 * verticesNumber * verticesNumber / edgesNumber << endl;
+
+    // Streaming solver's edge file: rows of varint targets instead of 16 byte (From, To, Weight) records.
+    const string fileName = "footprint-edges.bin";
+    ExternalMemoryBellmanFord::WriteEdgeFile(compressed, fileName);
+    ifstream edgeFile(fileName, ios::binary | ios::ate);
+    cout << "Edge file bytes per edge: " << (double)edgeFile.tellg() / edgesNumber << ", fixed records " << 16.0 << endl;
+    edgeFile.close();
+    remove(fileName.c_str());
+    // Result:
+    // 41963 edges, bytes per edge: compressed 10.01, plain CSR 12.00, matrix 762.58
+    // Edge file bytes per edge: 9.29, fixed records 16.00
+
+    // One relaxation pass over each representation from the same distances.
+    vector<double> distance(verticesNumber, 0.0);
+    auto begin = chrono::high_resolution_clock::now();
+    for (int from = 0; from < verticesNumber; from++)
+    {
+        compressed.ForEachEdge(from, [&](int to, double weight)
+        {
+            distance[to] = min(distance[to], distance[from] + weight);
+        });
+    }
+    auto end = chrono::high_resolution_clock::now();
+    cout << "Pass over compressed CSR: " << chrono::duration<double, milli>(end - begin).count() << " ms";
+
+    fill(distance.begin(), distance.end(), 0.0);
+    begin = chrono::high_resolution_clock::now();
+    for (int from = 0; from < verticesNumber; from++)
+    {
+        for (int to = 0; to < verticesNumber; to++)
+        {
+            if (graph.Matrix[from][to] != INF)
+            {
+                distance[to] = min(distance[to], distance[from] + graph.Matrix[from][to]);
+            }
+        }
+    }
+    end = chrono::high_resolution_clock::now();
+    cout << ", over matrix: " << chrono::duration<double, milli>(end - begin).count() << " ms" << endl;
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
+void runValidation(Graph& graph, int from)
+{
+    cout << "///////Differential validation of all engines////////////////////////////////////////////" << endl;
+    SolverValidation validation;
+    int failed = 0;
+
+    // Recorded graph: the last one loaded by the tests above.
+    failed += validation.Validate(graph, from, "recorded");
+
+    GraphGenerator::RandomRates(graph, 50, 1, 0.001, 0.0);
+    failed += validation.Validate(graph, from, "dense, no arbitrage");
+
+    GraphGenerator::RandomRates(graph, 50, 2, 0.001, 0.01);
+    failed += validation.Validate(graph, from, "dense, with arbitrage");
+
+    GraphGenerator::RandomRates(graph, 300, 3, 0.001, 0.0, 0.05);
+    failed += validation.Validate(graph, from, "sparse, no arbitrage");
+
+    GraphGenerator::RandomRates(graph, 300, 4, 0.001, 0.01, 0.05);
+    failed += validation.Validate(graph, from, "sparse, with arbitrage");
+
+    // Smallest negative cycle through all vertices: marks must reach every vertex of the cycle.
+    graph.Clear();
+    graph.Nodes = { { "A" }, { "B" }, { "C" } };
+    graph.Matrix = { { INF, 1.0, INF },
+                     { INF, INF, 1.0 },
+                     { -5.0, INF, INF } };
+    failed += validation.Validate(graph, from, "triangle cycle");
+
+    // Negative cycle which start cannot reach: only whole graph engines report it.
+    graph.Clear();
+    graph.Nodes = { { "A" }, { "B" }, { "C" }, { "D" } };
+    graph.Matrix = { { INF, 1.0, INF, INF },
+                     { INF, INF, INF, INF },
+                     { INF, INF, INF, -1.0 },
+                     { INF, INF, 0.5, INF } };
+    failed += validation.Validate(graph, from, "unreachable cycle");
+
+    // Adversarial inputs: worst cases of pass and queue based engines.
+    GraphGenerator::NegativeChain(graph, 300, false);
+    failed += validation.Validate(graph, from, "negative chain");
+
+    GraphGenerator::NegativeChain(graph, 300, true);
+    failed += validation.Validate(graph, from, "negative chain, closed");
+
+    GraphGenerator::GridWithCycle(graph, 15, 20, 1, false);
+    failed += validation.Validate(graph, from, "grid");
+
+    GraphGenerator::GridWithCycle(graph, 15, 20, 1, true);
+    failed += validation.Validate(graph, from, "grid with planted cycle");
+
+    GraphGenerator::SpfaKiller(graph, 100, 4, 1);
+    failed += validation.Validate(graph, from, "SPFA killer");
+
+    validation.PrintWorstTimes();
+    cout << (failed == 0 ? "All engines agree." : to_string(failed) + " disagreements found.") << endl;
+}
+
 int main(int argc, char** argv)
 {
+    if (argc > 1 && string(argv[1]) == "--benchmark")
+    {
+        return runDatasets(vector<string>(argv + 2, argv + argc)) == 0 ? 0 : 1;
+    }
+
     Graph graph;
     int from = 0;
 
@@ -579,5 +1118,38 @@ int main(int argc, char** argv)
     // Run more real use cases.
     runArbitrageTests(graph, from);
 
+    // Incremental detection on ticks.
+    runArbitrageMonitor(graph, from);
+
+    // What-if ranges of edge weights for the current solution.
+    runEdgeSensitivity(graph, from);
+
+    // Check that all engines agree with each other.
+    runValidation(graph, from);
+
+    // Large venue graph solved through its currency quotient.
+    runHierarchicalGraph(graph);
+
+    // Cycle search on the K best out-edges of every vertex first.
+    runTopKScreen(graph);
+
+    // Cheap int16 proof that a tick has no arbitrage.
+    runQuantizedScreen(graph);
+
+    // Heuristic cycle search for graphs too big for exact detection.
+    runBeamSearch(graph);
+
+    // Cycle search on what is left after dropping vertices without in- or out-edges.
+    runCyclePruning(graph);
+
+    // Scans and relaxations of FIFO, SLF and LLL queues.
+    runQueuePolicies(graph);
+
+    // Standard benchmark file formats.
+    runLoaders(graph);
+
+    // Memory traffic of the compressed storage.
+    runCompressedFootprint(graph);
+
     return 0;
 }
\ No newline at end of file
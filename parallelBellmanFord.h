@@ -0,0 +1,357 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Parallel_Bellman_Ford_H
+#define Parallel_Bellman_Ford_H
+
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "pathFindingBase.h"
+#include "bellmanFordAlgorithm.h"
+#include "bitReachability.h"
+#include "compressedGraph.h"
+
+/// <summary>
+/// Multithreaded Bellman-Ford over Graph::Matrix or CompressedGraph with the semantics and result fields of BellmanFordAlgorithm::FindPathsAndNegativeCycles.
+/// Vertices are split in contiguous ranges of targets, one range per thread, so every _shortestPath / _previousVertex entry has a single writer.
+/// Threads are started once per search and meet at a barrier after every pass, instead of being started and joined per pass.
+///
+/// Two modes:
+/// - Fast: threads relax in place and see each other's fresh distances as soon as they are written (fewer passes),
+///   but which of several equal-cost predecessors wins depends on thread timing.
+/// - Deterministic: every pass reads distances of the previous pass only (double buffered, buffers are swapped between passes),
+///   and each target picks the candidate with the smallest (distance, predecessor index). Results are identical run to run and
+///   for any number of threads, at the cost of a few more passes on long paths.
+///
+/// As in FindPathsAndNegativeCycles, when V - 1 passes do not converge, one more pass collects the vertices that still improve
+/// and every vertex reachable from them is marked as affected by a negative cycle.
+///
+/// A thread scans in-edges of its targets: a column of the matrix, or a row of the transposed CompressedGraph, which the CSR
+/// overload builds once per search (so a pass costs O(E) and reads ~10 bytes per edge instead of 8 * V per target).
+/// </summary>
+class ParallelBellmanFord : public BellmanFordAlgorithm
+{
+public:
+    enum class Mode
+    {
+        Fast,
+        Deterministic
+    };
+
+    ParallelBellmanFord(Mode mode = Mode::Fast, int threadsNumber = 0)
+        : _mode(mode),
+          _threadsNumber(threadsNumber > 0 ? threadsNumber : max(1, (int)thread::hardware_concurrency()))
+    {
+    }
+
+    bool FindPathsAndNegativeCycles(Graph& graph, int start)
+    {
+        int verticesNumber = graph.Nodes.size();
+        vector<int> improvable = _Solve(verticesNumber, start, [&graph, verticesNumber](int to, auto visit)
+        {
+            for (int from = 0; from < verticesNumber; from++)
+            {
+                if (graph.Matrix[from][to] != INF) // Edge exists
+                {
+                    visit(from, graph.Matrix[from][to]);
+                }
+            }
+        });
+
+        // DETECT nodes which are part of (or reachable from) a negative cycle.
+        bool negativeCycles = !improvable.empty();
+        if (negativeCycles)
+        {
+            BitReachability reachability;
+            reachability.Build(graph);
+            _MarkAffected(reachability.From(improvable));
+        }
+
+        _solved = true;
+
+        return negativeCycles;
+    }
+
+    bool FindPathsAndNegativeCycles(const CompressedGraph& graph, int start)
+    {
+        int verticesNumber = graph.VerticesNumber();
+
+        // In-edges of every target, sorted by source as the matrix columns are (Build keeps rows sorted).
+        vector<StreamEdge> reversed;
+        reversed.reserve(graph.EdgesNumber());
+        for (int from = 0; from < verticesNumber; from++)
+        {
+            graph.ForEachEdge(from, [&reversed, from](int to, double weight)
+            {
+                reversed.push_back({ to, from, weight });
+            });
+        }
+        CompressedGraph incoming;
+        incoming.Build(verticesNumber, reversed);
+        reversed = vector<StreamEdge>();
+
+        vector<int> improvable = _Solve(verticesNumber, start, [&incoming](int to, auto visit)
+        {
+            incoming.ForEachEdge(to, visit);
+        });
+
+        // DETECT nodes which are part of (or reachable from) a negative cycle: a search over out-edges, as bitset rows
+        // of V bits per vertex do not fit for graphs of this size.
+        bool negativeCycles = !improvable.empty();
+        if (negativeCycles)
+        {
+            vector<char> affected(verticesNumber, 0);
+            for (int v : improvable)
+            {
+                affected[v] = 1;
+            }
+            for (size_t i = 0; i < improvable.size(); i++)
+            {
+                graph.ForEachEdge(improvable[i], [&affected, &improvable](int to, double)
+                {
+                    if (!affected[to])
+                    {
+                        affected[to] = 1;
+                        improvable.push_back(to);
+                    }
+                });
+            }
+            _MarkAffected(affected);
+        }
+
+        _solved = true;
+
+        return negativeCycles;
+    }
+
+private:
+    /// <summary>
+    /// Reusable barrier for a fixed number of threads. The last thread to arrive runs the completion before anybody is released,
+    /// so the completion may change state the threads read after Wait.
+    /// </summary>
+    class PassBarrier
+    {
+    public:
+        PassBarrier(int threadsNumber, function<void()> completion)
+            : _threadsNumber(threadsNumber),
+              _completion(completion)
+        {
+        }
+
+        void Wait()
+        {
+            unique_lock<mutex> lock(_mutex);
+            int generation = _generation;
+            if (++_arrived == _threadsNumber)
+            {
+                _completion();
+                _arrived = 0;
+                _generation++;
+                _released.notify_all();
+                return;
+            }
+
+            _released.wait(lock, [this, generation]() { return _generation != generation; });
+        }
+
+    private:
+        int _threadsNumber;
+        function<void()> _completion;
+        mutex _mutex;
+        condition_variable _released;
+        int _arrived = 0;
+        int _generation = 0;
+    };
+
+    Mode _mode;
+    int _threadsNumber;
+    unique_ptr<atomic<double>[]> _sharedPath; // Fast mode: distances visible to all threads during the pass.
+    vector<double> _nextPath;                 // Deterministic mode: distances produced by the current pass.
+    vector<char> _improvable;                 // Targets which still improve after the last pass.
+
+    /// <summary>
+    /// Relaxation passes on worker threads. forEachInEdge(to, visit) calls visit(from, weight) for every edge into "to", in
+    /// ascending "from" order. Returns the vertices which still improve after V - 1 passes (none if the passes converged).
+    /// </summary>
+    template <typename InEdgeScanner>
+    vector<int> _Solve(int verticesNumber, int start, InEdgeScanner forEachInEdge)
+    {
+        _shortestPath.assign(verticesNumber, INF);
+        _previousVertex.assign(verticesNumber, -1);
+        _solved = false;
+
+        _shortestPath[start] = 0;
+
+        if (_mode == Mode::Fast)
+        {
+            _sharedPath.reset(new atomic<double>[verticesNumber]);
+            for (int i = 0; i < verticesNumber; i++)
+            {
+                _sharedPath[i].store(_shortestPath[i], memory_order_relaxed);
+            }
+        }
+        else
+        {
+            _nextPath = _shortestPath;
+        }
+
+        int threadsNumber = max(1, min(_threadsNumber, verticesNumber));
+        int rangeSize = (verticesNumber + threadsNumber - 1) / threadsNumber;
+        vector<char> updated(threadsNumber, 0);
+        _improvable.assign(verticesNumber, 0);
+
+        // Shared state, changed only by the barrier completion (on the last thread to arrive) while the others wait.
+        int passes = 0;
+        bool converged = false;
+        bool relaxing = verticesNumber > 1;
+        PassBarrier barrier(threadsNumber, [&]()
+        {
+            converged = find(updated.begin(), updated.end(), 1) == updated.end();
+            if (_mode == Mode::Deterministic)
+            {
+                _shortestPath.swap(_nextPath);
+            }
+            passes++;
+            relaxing = !converged && passes < verticesNumber - 1;
+        });
+
+        vector<thread> threads;
+        threads.reserve(threadsNumber);
+        for (int t = 0; t < threadsNumber; t++)
+        {
+            int first = min(verticesNumber, t * rangeSize);
+            int last = min(verticesNumber, first + rangeSize);
+            threads.emplace_back([this, &forEachInEdge, &updated, &barrier, &relaxing, &converged, t, first, last]()
+            {
+                // For each vertex, apply relaxation for all the edges to find PATH (if there are no negative cycles).
+                while (relaxing)
+                {
+                    updated[t] = _mode == Mode::Fast ? _RelaxRangeShared(forEachInEdge, first, last)
+                                                     : _RelaxRangeDeterministic(forEachInEdge, first, last);
+                    barrier.Wait();
+                }
+
+                if (!converged)
+                {
+                    _CollectImprovable(forEachInEdge, first, last);
+                }
+            });
+        }
+        for (thread& worker : threads)
+        {
+            worker.join();
+        }
+
+        if (_mode == Mode::Fast)
+        {
+            for (int i = 0; i < verticesNumber; i++)
+            {
+                _shortestPath[i] = _sharedPath[i].load(memory_order_relaxed);
+            }
+            _sharedPath.reset();
+        }
+
+        vector<int> improvable;
+        for (int v = 0; v < verticesNumber; v++)
+        {
+            if (_improvable[v])
+            {
+                improvable.push_back(v);
+            }
+        }
+        return improvable;
+    }
+
+    void _MarkAffected(const vector<char>& affected)
+    {
+        for (size_t v = 0; v < affected.size(); v++)
+        {
+            if (affected[v])
+            {
+                _shortestPath[v] = NEG_INF;
+                _previousVertex[v] = -2;
+            }
+        }
+    }
+
+    double _Distance(int v) const
+    {
+        return _mode == Mode::Fast ? _sharedPath[v].load(memory_order_relaxed) : _shortestPath[v];
+    }
+
+    template <typename InEdgeScanner>
+    bool _RelaxRangeShared(InEdgeScanner& forEachInEdge, int first, int last)
+    {
+        bool updated = false;
+        for (int to = first; to < last; to++)
+        {
+            double best = _sharedPath[to].load(memory_order_relaxed);
+            forEachInEdge(to, [&](int from, double weight)
+            {
+                double candidate = _sharedPath[from].load(memory_order_relaxed) + weight;
+                if (best > candidate)
+                {
+                    best = candidate;
+                    _previousVertex[to] = from;
+                    _sharedPath[to].store(best, memory_order_relaxed);
+                    updated = true;
+                }
+            });
+        }
+
+        return updated;
+    }
+
+    template <typename InEdgeScanner>
+    bool _RelaxRangeDeterministic(InEdgeScanner& forEachInEdge, int first, int last)
+    {
+        bool updated = false;
+        for (int to = first; to < last; to++)
+        {
+            // Scanning predecessors in ascending order with a strict comparison picks the smallest (distance, predecessor index).
+            double best = _shortestPath[to];
+            int bestFrom = -1;
+            forEachInEdge(to, [&](int from, double weight)
+            {
+                double candidate = _shortestPath[from] + weight;
+                if (best > candidate)
+                {
+                    best = candidate;
+                    bestFrom = from;
+                }
+            });
+
+            // Every target is written, so the buffers can be swapped instead of copied.
+            _nextPath[to] = best;
+            if (bestFrom != -1)
+            {
+                _previousVertex[to] = bestFrom;
+                updated = true;
+            }
+        }
+
+        return updated;
+    }
+
+    template <typename InEdgeScanner>
+    void _CollectImprovable(InEdgeScanner& forEachInEdge, int first, int last)
+    {
+        for (int to = first; to < last; to++)
+        {
+            forEachInEdge(to, [&](int from, double weight)
+            {
+                if (_Distance(to) > _Distance(from) + weight)
+                {
+                    _improvable[to] = 1;
+                }
+            });
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,129 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Pareto_Paths_H
+#define Pareto_Paths_H
+
+#include <algorithm>
+#include "pathFindingBase.h"
+
+/// <summary>
+/// Point of the Pareto front of paths to one target: the best cost reachable with at most Legs conversions,
+/// strictly better than any path with fewer legs.
+/// </summary>
+struct ParetoPoint
+{
+    int Legs;
+    double Cost;
+};
+
+/// <summary>
+/// Pareto front of (cost, number of legs) for every target in a single run, instead of one solve per hop limit.
+///
+/// Layered Bellman-Ford: layer k holds, per vertex, the best cost of a walk from start with at most k legs.
+/// All layers are kept in one compact (K + 1) x V array, and each layer is computed row by row of Graph::Matrix with a branch free
+/// min over contiguous memory, which compilers vectorize. Predecessors are not stored: the few front paths are rebuilt on demand
+/// by looking for the edge that produced the value.
+/// </summary>
+class ParetoPathFinder
+{
+public:
+    void Solve(const Graph& graph, int start, int maxLegs)
+    {
+        _verticesNumber = graph.Nodes.size();
+        _maxLegs = maxLegs;
+        _cost.assign((size_t)(maxLegs + 1) * _verticesNumber, INF);
+        _cost[start] = 0;
+
+        for (int k = 1; k <= maxLegs; k++)
+        {
+            const double* current = _Layer(k - 1);
+            double* next = _Layer(k);
+            copy(current, current + _verticesNumber, next); // Staying with fewer legs is allowed.
+
+            for (int from = 0; from < _verticesNumber; from++)
+            {
+                double distance = current[from];
+                if (distance >= INF / 2) // Not reached with k - 1 legs.
+                {
+                    continue;
+                }
+
+                const double* row = graph.Matrix[from].data();
+                for (int to = 0; to < _verticesNumber; to++)
+                {
+                    double candidate = distance + row[to];
+                    next[to] = candidate < next[to] ? candidate : next[to];
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Pareto front to the target, ordered by number of legs (so by decreasing cost).
+    /// </summary>
+    vector<ParetoPoint> Front(int target) const
+    {
+        vector<ParetoPoint> front;
+        double best = INF / 2;
+        for (int k = 0; k <= _maxLegs; k++)
+        {
+            double cost = _Layer(k)[target];
+            if (cost < best)
+            {
+                best = cost;
+                front.push_back({ k, cost });
+            }
+        }
+        return front;
+    }
+
+    /// <summary>
+    /// Walk start ... target of the front point with the given number of legs.
+    /// </summary>
+    vector<int> Path(const Graph& graph, int target, int legs) const
+    {
+        vector<int> path = { target };
+        int at = target;
+        for (int k = legs; k > 0; k--)
+        {
+            const double* previous = _Layer(k - 1);
+            double cost = _Layer(k)[at];
+            if (cost == previous[at]) // Value came from the layer below: no leg taken here.
+            {
+                continue;
+            }
+
+            for (int from = 0; from < _verticesNumber; from++)
+            {
+                if (previous[from] < INF / 2 && previous[from] + graph.Matrix[from][at] == cost)
+                {
+                    at = from;
+                    break;
+                }
+            }
+            path.push_back(at);
+        }
+
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+private:
+    int _verticesNumber = 0;
+    int _maxLegs = 0;
+    vector<double> _cost; // Layer-major: _cost[k * V + v].
+
+    double* _Layer(int k)
+    {
+        return _cost.data() + (size_t)k * _verticesNumber;
+    }
+
+    const double* _Layer(int k) const
+    {
+        return _cost.data() + (size_t)k * _verticesNumber;
+    }
+};
+
+#endif
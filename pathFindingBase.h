@@ -6,6 +6,7 @@
 #define Path_Finding_Base_H
 
 #include <vector>
+#include <string>
 #include <memory>
 
 using namespace std;
@@ -25,13 +26,25 @@ public:
 	void Clear()
 	{
 		Matrix.clear();
+		Latency.clear();
 		Edges.clear();
 		Nodes.clear();
 	}
 
 	vector<vector<double>> Matrix;
+	vector<vector<double>> Latency; // Optional second attribute of edges in Matrix (e.g. venue latency), same shape.
 	vector<vector<pair<int, int>>> Edges;
 	vector<GraphNode> Nodes;
 };
 
+/// <summary>
+/// New weight of one edge of Graph::Matrix, received with a market data tick.
+/// </summary>
+struct EdgeUpdate
+{
+	int From;
+	int To;
+	double Weight;
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,162 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Quantized_Screen_H
+#define Quantized_Screen_H
+
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include "pathFindingBase.h"
+#include "bellmanFordAlgorithm.h"
+
+/// <summary>
+/// Two stage negative cycle detection for the common case of "no cycle on this tick".
+///
+/// Stage 1 works on a copy of Graph::Matrix quantized to int16: q = floor(w / scale), saturated to [-32767, 32766], where scale
+/// makes the most negative weight fit, and 32767 marks a missing edge. Rounding down and saturating big positive weights down only
+/// make weights smaller, so every cycle of the quantized graph is not heavier than the real one (times scale): if the quantized graph has no negative
+/// cycle, neither has the real one. Distances are int32 and exact, the weight matrix takes a quarter of the memory of the doubles,
+/// and the relaxation of a row is a branch free min loop which compilers vectorize.
+/// Stage 2, the exact BellmanFordAlgorithm::FindAnyNegativeCycle, runs only when stage 1 can not prove there is no cycle.
+/// </summary>
+class QuantizedScreen
+{
+public:
+    /// <summary>
+    /// Quantizes the whole matrix and picks the scale.
+    /// </summary>
+    void Build(const Graph& graph)
+    {
+        _verticesNumber = graph.Matrix.size();
+        double lowest = 0;
+        for (const vector<double>& row : graph.Matrix)
+        {
+            for (double weight : row)
+            {
+                lowest = min(lowest, weight);
+            }
+        }
+        _lowest = lowest;
+        _scale = lowest < 0 ? -lowest / (LIMIT - 1) : 1.0; // One unit of slack for rounding of the division.
+
+        _weights.resize((size_t)_verticesNumber * _verticesNumber);
+        for (int from = 0; from < _verticesNumber; from++)
+        {
+            for (int to = 0; to < _verticesNumber; to++)
+            {
+                _weights[(size_t)from * _verticesNumber + to] = _Quantize(graph.Matrix[from][to]);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Applies the updates to the graph and to the quantized copy. A weight below the range of the scale triggers a new Build.
+    /// </summary>
+    void OnTick(Graph& graph, const vector<EdgeUpdate>& updates)
+    {
+        bool rebuild = false;
+        for (const EdgeUpdate& update : updates)
+        {
+            graph.Matrix[update.From][update.To] = update.Weight;
+            rebuild = rebuild || update.Weight < _lowest;
+            _weights[(size_t)update.From * _verticesNumber + update.To] = _Quantize(update.Weight);
+        }
+
+        if (rebuild)
+        {
+            Build(graph);
+        }
+    }
+
+    /// <summary>
+    /// Returns a negative cycle in edge order, or empty vector if there is none.
+    /// </summary>
+    vector<int> FindNegativeCycle(Graph& graph)
+    {
+        if (_ProvesNoNegativeCycle())
+        {
+            _proved++;
+            return {};
+        }
+
+        _exactSolves++;
+        return _solver.FindAnyNegativeCycle(graph);
+    }
+
+    double Scale() const
+    {
+        return _scale;
+    }
+
+    /// <summary>
+    /// Searches answered by the quantized stage alone.
+    /// </summary>
+    int Proved() const
+    {
+        return _proved;
+    }
+
+    int ExactSolves() const
+    {
+        return _exactSolves;
+    }
+
+private:
+    static constexpr int LIMIT = 32767;
+    static constexpr int16_t MISSING = 32767;
+
+    int _verticesNumber = 0;
+    double _lowest = 0;  // Most negative weight the scale can represent.
+    double _scale = 1.0;
+    int _proved = 0;
+    int _exactSolves = 0;
+    vector<int16_t> _weights; // Row-major V x V.
+    vector<int32_t> _distance;
+    BellmanFordAlgorithm _solver;
+
+    int16_t _Quantize(double weight) const
+    {
+        if (weight == INF) // Edge not exists
+        {
+            return MISSING;
+        }
+        double units = floor(weight / _scale);
+        return (int16_t)max(-(double)LIMIT, min((double)(LIMIT - 1), units));
+    }
+
+    /// <summary>
+    /// Bellman-Ford on the quantized weights from a virtual vertex connected to all vertices. Integer distances
+    /// improve by at least one unit, so V passes either settle or show a (quantized) negative cycle.
+    /// </summary>
+    bool _ProvesNoNegativeCycle()
+    {
+        _distance.assign(_verticesNumber, 0);
+        int32_t* distance = _distance.data(); // Relaxed in place, so a pass already sees its own improvements.
+        for (int k = 0; k < _verticesNumber; k++)
+        {
+            int updated = 0;
+            for (int from = 0; from < _verticesNumber; from++)
+            {
+                int32_t fromDistance = distance[from];
+                const int16_t* row = _weights.data() + (size_t)from * _verticesNumber;
+                for (int to = 0; to < _verticesNumber; to++)
+                {
+                    int32_t candidate = row[to] == MISSING ? distance[to] : fromDistance + row[to];
+                    updated |= candidate < distance[to];
+                    distance[to] = candidate < distance[to] ? candidate : distance[to];
+                }
+            }
+
+            if (!updated)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
+
+#endif
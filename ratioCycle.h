@@ -0,0 +1,218 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Ratio_Cycle_H
+#define Ratio_Cycle_H
+
+#include <iostream>
+#include <algorithm>
+#include "pathFindingBase.h"
+
+/// <summary>
+/// Minimum cost-to-time ratio cycle (Lawler): the cycle C minimizing cost(C) / time(C), where cost is Graph::Matrix and time is
+/// a second positive per-edge quantity (number of legs, latency, fee units...). With fixed per-trade costs this is the cycle with
+/// the best profit per trade rather than the best total profit.
+///
+/// For a parameter lambda, a cycle with ratio below lambda exists iff the graph with weights cost - lambda * time has a negative cycle.
+/// Starting above every possible ratio, each step finds a negative cycle and moves lambda to its ratio (Newton / Dinkelbach step),
+/// until no negative cycle is left: the last cycle is optimal. Steps are few, and every step starts Bellman-Ford from distances
+/// of the previous one (any finite start is valid), so it runs far fewer passes than solving each lambda from scratch.
+/// Diagonal of the matrices is ignored.
+/// </summary>
+class MinimumRatioCycle
+{
+public:
+    /// <summary>
+    /// Returns the optimal cycle in edge order, or empty vector if the graph has no cycle or some edge has non-positive time.
+    /// Times must have the same shape as graph.Matrix; empty times means one unit per edge (minimum mean cycle).
+    /// </summary>
+    vector<int> Solve(const Graph& graph, const vector<vector<double>>& times = {})
+    {
+        int verticesNumber = graph.Matrix.size();
+        _steps = 0;
+        _passes = 0;
+        _ratio = INF;
+
+        double maxRatio = -INF;
+        for (int from = 0; from < verticesNumber; from++)
+        {
+            for (int to = 0; to < verticesNumber; to++)
+            {
+                if (from == to || graph.Matrix[from][to] == INF)
+                {
+                    continue;
+                }
+
+                double time = _Time(times, from, to);
+                if (time <= 0)
+                {
+                    cout << "Time of edge " << from << "->" << to << " must be positive." << endl;
+                    return {};
+                }
+                maxRatio = max(maxRatio, graph.Matrix[from][to] / time);
+            }
+        }
+
+        if (maxRatio == -INF)
+        {
+            return {};
+        }
+
+        _distance.assign(verticesNumber, 0.0);
+
+        // Every cycle has ratio not above the largest edge ratio, so every cycle is negative for the first lambda.
+        double lambda = maxRatio + 1.0;
+        vector<int> best;
+        while (true)
+        {
+            _steps++;
+            vector<int> cycle = _FindNegativeCycle(graph, times, lambda);
+            if (cycle.empty())
+            {
+                break;
+            }
+
+            double ratio = Ratio(graph, times, cycle);
+            if (!best.empty() && ratio >= _ratio)
+            {
+                break; // Rounding: the same cycle found again at its own ratio.
+            }
+
+            best = cycle;
+            _ratio = ratio;
+            lambda = ratio;
+        }
+
+        return best;
+    }
+
+    static double Ratio(const Graph& graph, const vector<vector<double>>& times, const vector<int>& cycle)
+    {
+        double cost = 0;
+        double time = 0;
+        for (size_t i = 0; i < cycle.size(); i++)
+        {
+            int from = cycle[i];
+            int to = cycle[(i + 1) % cycle.size()];
+            cost += graph.Matrix[from][to];
+            time += _Time(times, from, to);
+        }
+        return cost / time;
+    }
+
+    double BestRatio() const
+    {
+        return _ratio;
+    }
+
+    int Steps() const
+    {
+        return _steps;
+    }
+
+    int Passes() const
+    {
+        return _passes;
+    }
+
+private:
+    // Improvements below rounding noise are ignored, otherwise the cycle found on the previous step (zero weight at its own ratio)
+    // keeps relaxing and hides better cycles.
+    static constexpr double EPSILON = 1e-12;
+
+    vector<double> _distance; // Kept between steps: warm start for the next lambda.
+    vector<int> _previousVertex;
+    double _ratio = INF;
+    int _steps = 0;
+    int _passes = 0;
+
+    static double _Time(const vector<vector<double>>& times, int from, int to)
+    {
+        return times.empty() ? 1.0 : times[from][to];
+    }
+
+    /// <summary>
+    /// Bellman-Ford on weights cost - lambda * time from the current distances. Returns a cycle of the predecessor graph
+    /// (every such cycle is negative) as soon as one appears, or empty vector once distances stop changing.
+    /// </summary>
+    vector<int> _FindNegativeCycle(const Graph& graph, const vector<vector<double>>& times, double lambda)
+    {
+        int verticesNumber = graph.Matrix.size();
+        _previousVertex.assign(verticesNumber, -1);
+
+        // Without negative cycle distances settle in V - 1 passes; with one, the predecessor graph gets a cycle.
+        // The limit is only a safety net.
+        for (int k = 0; k < verticesNumber * verticesNumber; k++)
+        {
+            _passes++;
+            bool updated = false;
+            for (int from = 0; from < verticesNumber; from++)
+            {
+                for (int to = 0; to < verticesNumber; to++)
+                {
+                    if (from == to || graph.Matrix[from][to] == INF)
+                    {
+                        continue;
+                    }
+
+                    double weight = graph.Matrix[from][to] - lambda * _Time(times, from, to);
+                    if (_distance[to] > _distance[from] + weight + EPSILON)
+                    {
+                        _distance[to] = _distance[from] + weight;
+                        _previousVertex[to] = from;
+                        updated = true;
+                    }
+                }
+            }
+
+            if (!updated)
+            {
+                return {};
+            }
+
+            vector<int> cycle = _PredecessorCycle();
+            if (!cycle.empty())
+            {
+                return cycle;
+            }
+        }
+
+        return {};
+    }
+
+    /// <summary>
+    /// Any cycle formed by _previousVertex links, in edge order; O(V).
+    /// </summary>
+    vector<int> _PredecessorCycle() const
+    {
+        int verticesNumber = _previousVertex.size();
+        vector<int> visitedBy(verticesNumber, -1);
+        for (int v = 0; v < verticesNumber; v++)
+        {
+            int at = v;
+            while (at != -1 && visitedBy[at] == -1)
+            {
+                visitedBy[at] = v;
+                at = _previousVertex[at];
+            }
+
+            if (at != -1 && visitedBy[at] == v) // Came back to a vertex of this walk: it is on a cycle.
+            {
+                vector<int> cycle;
+                int c = at;
+                do
+                {
+                    cycle.push_back(c);
+                    c = _previousVertex[c];
+                } while (c != at);
+                reverse(cycle.begin(), cycle.end());
+                return cycle;
+            }
+        }
+
+        return {};
+    }
+};
+
+#endif
@@ -0,0 +1,120 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Solver_Checkpoint_H
+#define Solver_Checkpoint_H
+
+#include <cstdint>
+#include <climits>
+#include <fstream>
+#include <string>
+#include "pathFindingBase.h"
+#include "bellmanFordAlgorithm.h"
+
+/// <summary>
+/// Binary checkpoint of BellmanFordAlgorithm state (distances, predecessor tree, solved flag) tagged with the
+/// version of the graph snapshot it was computed for. Distances double as potentials for warm restarts.
+///
+/// File layout: header, then _shortestPath as V doubles, then _previousVertex as V int32.
+/// Arrays are written raw, so restoring is two bulk reads straight into the vectors.
+/// </summary>
+class SolverCheckpoint
+{
+public:
+    static bool Save(const BellmanFordAlgorithm& algo, uint64_t snapshotVersion, const string& fileName)
+    {
+        ofstream file(fileName, ios::binary | ios::trunc);
+        if (!file)
+        {
+            cout << "Cannot open checkpoint " << fileName << " for writing." << endl;
+            return false;
+        }
+
+        Header header = {};
+        header.Magic = MAGIC;
+        header.FormatVersion = FORMAT_VERSION;
+        header.SnapshotVersion = snapshotVersion;
+        header.VerticesNumber = algo._shortestPath.size();
+        header.Solved = algo._solved ? 1 : 0;
+
+        vector<int32_t> previous(algo._previousVertex.begin(), algo._previousVertex.end());
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(reinterpret_cast<const char*>(algo._shortestPath.data()), header.VerticesNumber * sizeof(double));
+        file.write(reinterpret_cast<const char*>(previous.data()), header.VerticesNumber * sizeof(int32_t));
+
+        return (bool)file;
+    }
+
+    /// <summary>
+    /// Restores the state saved by Save. Fails (leaving algo untouched) if the file is missing or corrupted,
+    /// or if it was written for a different graph snapshot than expectedSnapshotVersion.
+    /// </summary>
+    static bool Load(BellmanFordAlgorithm& algo, uint64_t expectedSnapshotVersion, const string& fileName)
+    {
+        ifstream file(fileName, ios::binary);
+        if (!file)
+        {
+            cout << "Cannot open checkpoint " << fileName << "." << endl;
+            return false;
+        }
+
+        Header header = {};
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(Header)) ||
+            header.Magic != MAGIC || header.FormatVersion != FORMAT_VERSION)
+        {
+            cout << "Checkpoint " << fileName << " is not valid." << endl;
+            return false;
+        }
+
+        if (header.SnapshotVersion != expectedSnapshotVersion)
+        {
+            cout << "Checkpoint " << fileName << " is for graph snapshot " << header.SnapshotVersion
+                 << ", expected " << expectedSnapshotVersion << "." << endl;
+            return false;
+        }
+
+        // Check the arrays against the rest of the file before allocating them: a corrupted header must not cause a huge allocation.
+        streamoff arraysStart = file.tellg();
+        file.seekg(0, ios::end);
+        uint64_t remaining = (uint64_t)(file.tellg() - arraysStart);
+        file.seekg(arraysStart);
+        if (header.VerticesNumber > (uint64_t)INT_MAX ||
+            header.VerticesNumber * (sizeof(double) + sizeof(int32_t)) > remaining)
+        {
+            cout << "Checkpoint " << fileName << " is truncated." << endl;
+            return false;
+        }
+
+        vector<double> shortestPath(header.VerticesNumber);
+        vector<int32_t> previous(header.VerticesNumber);
+        if (!file.read(reinterpret_cast<char*>(shortestPath.data()), header.VerticesNumber * sizeof(double)) ||
+            !file.read(reinterpret_cast<char*>(previous.data()), header.VerticesNumber * sizeof(int32_t)))
+        {
+            cout << "Checkpoint " << fileName << " is truncated." << endl;
+            return false;
+        }
+
+        algo._shortestPath.swap(shortestPath);
+        algo._previousVertex.assign(previous.begin(), previous.end());
+        algo._solved = header.Solved != 0;
+
+        return true;
+    }
+
+private:
+    static const uint32_t MAGIC = 0x4B434642; // "BFCK"
+    static const uint32_t FORMAT_VERSION = 1;
+
+    struct Header
+    {
+        uint32_t Magic;
+        uint32_t FormatVersion;
+        uint64_t SnapshotVersion;
+        uint64_t VerticesNumber;
+        uint64_t Solved;
+    };
+};
+
+#endif
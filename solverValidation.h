@@ -0,0 +1,362 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Solver_Validation_H
+#define Solver_Validation_H
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <string>
+#include "pathFindingBase.h"
+#include "bellmanFordAlgorithm.h"
+#include "bitReachability.h"
+#include "externalMemoryBellmanFord.h"
+#include "compressedGraph.h"
+#include "parallelBellmanFord.h"
+#include "labelCorrectingSolver.h"
+#include "cyclePruning.h"
+#include "hierarchicalGraph.h"
+#include "topKScreen.h"
+#include "quantizedScreen.h"
+
+/// <summary>
+/// Differential validation of all solver engines: runs each of them on the same graph, compares the results
+/// with BellmanFordAlgorithm::FindPathsAndNegativeCycles (the reference) and prints time spent by every engine,
+/// so that speed and correctness regressions show up in one table.
+///
+/// What is compared depends on what an engine is able to tell:
+/// - negative cycle flag, for engines detecting cycles. There are two reference flags: whether the graph has any negative cycle
+///   (FindAnyNegativeCycle; the reference flags unreachable cycles too, as labels of unreachable vertices start at INF and still
+///   decrease along negative edges) and whether a negative cycle is reachable from start (FindAnyNegativeCycle on the vertices
+///   start reaches), for engines which scan only what start reaches;
+/// - set of NEG_INF vertices, for engines marking vertices affected by a cycle;
+/// - distances of reachable vertices within tolerance, when the graph has no negative cycle (or the engine marks affected vertices),
+///   for engines computing distances (cycle search engines only tell whether the graph has a negative cycle);
+/// - the negative cycle found by FindNegativeCycle must have negative weight and all its vertices must be marked.
+/// The slowest run of every engine over all validated graphs is kept, so adversarial inputs show the tail latency of each engine.
+/// </summary>
+class SolverValidation
+{
+public:
+    struct Engine
+    {
+        string Name;
+        bool DetectsCycles;
+        bool MarksCycleVertices;
+        function<bool(Graph&, int, vector<double>&)> Run; // Returns negative cycle flag and fills distances.
+        bool ComputesDistances = true;
+        bool ReachableCyclesOnly = false; // Sees only negative cycles reachable from start.
+    };
+
+    SolverValidation(double tolerance = 1e-9)
+        : _tolerance(tolerance)
+    {
+        _AddBellmanFordEngines();
+        _AddCycleSearchEngines();
+    }
+
+    /// <summary>
+    /// Validates all engines on one graph. Returns number of engines that disagree with the reference.
+    /// </summary>
+    int Validate(Graph& graph, int start, const string& label)
+    {
+        vector<double> reference;
+        bool referenceCycle = _engines[0].Run(graph, start, reference);
+
+        BellmanFordAlgorithm cycleFinder;
+        vector<int> cycle = cycleFinder.FindNegativeCycle(graph, start);
+        bool anyCycle = _IsNegativeCycle(graph, cycleFinder.FindAnyNegativeCycle(graph));
+
+        BitReachability reachability;
+        reachability.Build(graph);
+        vector<char> reachable = reachability.From({ start });
+        bool reachableCycle = _IsNegativeCycle(graph, cycleFinder.FindAnyNegativeCycle(graph, reachable));
+
+        cout << "Validation of '" << label << "' (" << graph.Nodes.size() << " vertices), negative cycle: "
+             << (anyCycle ? (reachableCycle ? "yes" : "yes, not reachable from start") : "no");
+        if (!cycle.empty())
+        {
+            cout << ", cycle of " << cycle.size() << " edges with weight " << BellmanFordAlgorithm::CycleWeight(graph, cycle);
+        }
+        cout << endl;
+
+        int failed = 0;
+        if (referenceCycle != anyCycle || reachableCycle != !cycle.empty() ||
+            (!cycle.empty() && BellmanFordAlgorithm::CycleWeight(graph, cycle) >= 0))
+        {
+            cout << "    Reference cycle check FAILED." << endl;
+            failed++;
+        }
+
+        _worst.resize(_engines.size());
+        for (size_t e = 0; e < _engines.size(); e++)
+        {
+            const Engine& engine = _engines[e];
+            bool expectedCycle = engine.ReachableCyclesOnly ? reachableCycle : anyCycle;
+            if (expectedCycle && !engine.DetectsCycles)
+            {
+                // Engines without protection against cycles may not terminate in reasonable time and memory.
+                cout << "    " << left << setw(40) << engine.Name << right << "skipped (no protection against cycles)" << endl;
+                continue;
+            }
+
+            vector<double> distances;
+            auto begin = chrono::high_resolution_clock::now();
+            bool negativeCycle = engine.Run(graph, start, distances);
+            auto end = chrono::high_resolution_clock::now();
+            double ms = chrono::duration<double, milli>(end - begin).count();
+            if (ms >= _worst[e].first)
+            {
+                _worst[e] = { ms, label };
+            }
+
+            string error = _Compare(engine, expectedCycle, reference, reachable, cycle, negativeCycle, distances);
+            if (!error.empty())
+            {
+                failed++;
+            }
+
+            cout << "    " << left << setw(40) << engine.Name << right << setw(12) << fixed << setprecision(3) << ms << " ms   "
+                 << (error.empty() ? "OK" : "FAILED: " + error) << endl;
+            cout.unsetf(ios::fixed);
+            cout << setprecision(6);
+        }
+
+        return failed;
+    }
+
+    /// <summary>
+    /// Prints the slowest run of every engine and the graph it was on.
+    /// </summary>
+    void PrintWorstTimes() const
+    {
+        cout << "Worst time per engine:" << endl;
+        for (size_t e = 0; e < _worst.size(); e++)
+        {
+            cout << "    " << left << setw(40) << _engines[e].Name << right << setw(12) << fixed << setprecision(3) << _worst[e].first
+                 << " ms   " << _worst[e].second << endl;
+            cout.unsetf(ios::fixed);
+            cout << setprecision(6);
+        }
+    }
+
+private:
+    double _tolerance;
+    vector<Engine> _engines;
+    vector<pair<double, string>> _worst; // Per engine: slowest time (ms) and label of the graph.
+
+    void _AddBellmanFordEngines()
+    {
+        // Reference engine goes first.
+        _engines.push_back({ "FindPathsAndNegativeCycles", true, true, [](Graph& graph, int start, vector<double>& distances)
+        {
+            BellmanFordAlgorithm algo;
+            bool result = algo.FindPathsAndNegativeCycles(graph, start);
+            distances = algo._shortestPath;
+            return result;
+        } });
+        _engines.push_back({ "ContainsNegativeCycles", true, false, [](Graph& graph, int start, vector<double>& distances)
+        {
+            BellmanFordAlgorithm algo;
+            bool result = algo.ContainsNegativeCycles(graph, start);
+            distances = algo._shortestPath;
+            return result;
+        } });
+        _engines.push_back({ "ContainsNegativeCycles_Sedgewick", true, false, [](Graph& graph, int start, vector<double>& distances)
+        {
+            BellmanFordAlgorithm algo;
+            bool result = algo.ContainsNegativeCycles_Sedgewick(graph, start);
+            distances = algo._shortestPath;
+            return result;
+        }, true, true });
+        _engines.push_back({ "FindPathOnly", false, false, [](Graph& graph, int start, vector<double>& distances)
+        {
+            BellmanFordAlgorithm algo;
+            algo.FindPathOnly(graph, start);
+            distances = algo._shortestPath;
+            return false;
+        }, true, true });
+        _AddLabelCorrectingEngine<FifoPolicy>("LabelCorrecting (FIFO)");
+        _AddLabelCorrectingEngine<SmallLabelFirstPolicy>("LabelCorrecting (SLF)");
+        _AddLabelCorrectingEngine<LargeLabelLastPolicy>("LabelCorrecting (LLL)");
+        _AddLabelCorrectingEngine<SmallLabelFirstLargeLabelLastPolicy>("LabelCorrecting (SLF + LLL)");
+        _engines.push_back({ "ExternalMemoryBellmanFord", true, true, [](Graph& graph, int start, vector<double>& distances)
+        {
+            const string fileName = "validation-edges.bin";
+            ExternalMemoryBellmanFord algo;
+            ExternalMemoryBellmanFord::WriteEdgeFile(graph, fileName);
+            bool result = algo.FindPathsAndNegativeCycles(fileName, graph.Nodes.size(), start);
+            remove(fileName.c_str());
+            distances = algo._shortestPath;
+            return result;
+        } });
+        _engines.push_back({ "CompressedBellmanFord", true, true, [](Graph& graph, int start, vector<double>& distances)
+        {
+            CompressedGraph compressed;
+            compressed.Build(graph);
+            CompressedBellmanFord algo;
+            bool result = algo.FindPathsAndNegativeCycles(compressed, start);
+            distances = algo._shortestPath;
+            return result;
+        } });
+        _engines.push_back({ "ParallelBellmanFord (fast)", true, true, [](Graph& graph, int start, vector<double>& distances)
+        {
+            ParallelBellmanFord algo(ParallelBellmanFord::Mode::Fast);
+            bool result = algo.FindPathsAndNegativeCycles(graph, start);
+            distances = algo._shortestPath;
+            return result;
+        } });
+        _engines.push_back({ "ParallelBellmanFord (deterministic)", true, true, [](Graph& graph, int start, vector<double>& distances)
+        {
+            ParallelBellmanFord algo(ParallelBellmanFord::Mode::Deterministic);
+            bool result = algo.FindPathsAndNegativeCycles(graph, start);
+            distances = algo._shortestPath;
+            return result;
+        } });
+        _engines.push_back({ "ParallelBellmanFord CSR (fast)", true, true, [](Graph& graph, int start, vector<double>& distances)
+        {
+            CompressedGraph compressed;
+            compressed.Build(graph);
+            ParallelBellmanFord algo(ParallelBellmanFord::Mode::Fast);
+            bool result = algo.FindPathsAndNegativeCycles(compressed, start);
+            distances = algo._shortestPath;
+            return result;
+        } });
+        _engines.push_back({ "ParallelBellmanFord CSR (deterministic)", true, true, [](Graph& graph, int start, vector<double>& distances)
+        {
+            CompressedGraph compressed;
+            compressed.Build(graph);
+            ParallelBellmanFord algo(ParallelBellmanFord::Mode::Deterministic);
+            bool result = algo.FindPathsAndNegativeCycles(compressed, start);
+            distances = algo._shortestPath;
+            return result;
+        } });
+    }
+
+    /// <summary>
+    /// Engines searching for any negative cycle of the whole graph, compared with the whole graph flag.
+    /// A returned cycle counts only if it really is a negative cycle.
+    /// </summary>
+    void _AddCycleSearchEngines()
+    {
+        _engines.push_back({ "FindAnyNegativeCycle (pruned)", true, false, [](Graph& graph, int, vector<double>&)
+        {
+            CyclePruning pruning;
+            pruning.Compute(graph);
+            BellmanFordAlgorithm algo;
+            return _IsNegativeCycle(graph, algo.FindAnyNegativeCycle(graph, pruning.Active));
+        }, false });
+        _engines.push_back({ "HierarchicalGraph", true, false, [](Graph& graph, int, vector<double>&)
+        {
+            // Groups of 4 consecutive vertices play currencies, so the coarse screen and the refinement both run.
+            int verticesNumber = graph.Matrix.size();
+            vector<int> currencyOf(verticesNumber);
+            vector<string> currencyNames((verticesNumber + 3) / 4);
+            for (int v = 0; v < verticesNumber; v++)
+            {
+                currencyOf[v] = v / 4;
+                currencyNames[v / 4] = "G" + to_string(v / 4);
+            }
+            HierarchicalGraph hierarchy;
+            hierarchy.Build(graph, currencyOf, currencyNames);
+            return _IsNegativeCycle(graph, hierarchy.FindNegativeCycle(graph));
+        }, false });
+        _engines.push_back({ "TopKScreen (4 edges)", true, false, [](Graph& graph, int, vector<double>&)
+        {
+            TopKScreen screen(4);
+            screen.Build(graph);
+            return _IsNegativeCycle(graph, screen.FindNegativeCycle(graph));
+        }, false });
+        _engines.push_back({ "QuantizedScreen", true, false, [](Graph& graph, int, vector<double>&)
+        {
+            QuantizedScreen screen;
+            screen.Build(graph);
+            return _IsNegativeCycle(graph, screen.FindNegativeCycle(graph));
+        }, false });
+    }
+
+    static bool _IsNegativeCycle(const Graph& graph, const vector<int>& cycle)
+    {
+        for (size_t i = 0; i < cycle.size(); i++)
+        {
+            if (graph.Matrix[cycle[i]][cycle[(i + 1) % cycle.size()]] == INF)
+            {
+                return false;
+            }
+        }
+        return !cycle.empty() && BellmanFordAlgorithm::CycleWeight(graph, cycle) < 0;
+    }
+
+    template <class QueuePolicy>
+    void _AddLabelCorrectingEngine(const string& name)
+    {
+        _engines.push_back({ name, true, false, [](Graph& graph, int start, vector<double>& distances)
+        {
+            LabelCorrectingSolver<QueuePolicy> algo;
+            bool result = algo.FindPathsAndNegativeCycles(graph, start);
+            distances = algo._shortestPath;
+            return result;
+        }, true, true });
+    }
+
+    /// <summary>
+    /// expectedCycle is the reference flag matching the engine: reachable from start or anywhere in the graph.
+    /// </summary>
+    string _Compare(const Engine& engine, bool expectedCycle, const vector<double>& reference, const vector<char>& reachable,
+                    const vector<int>& cycle, bool negativeCycle, const vector<double>& distances) const
+    {
+        if (engine.DetectsCycles && negativeCycle != expectedCycle)
+        {
+            return negativeCycle ? "reports a negative cycle" : "misses the negative cycle";
+        }
+
+        if (!engine.ComputesDistances || (expectedCycle && !engine.MarksCycleVertices))
+        {
+            return ""; // Distances are not meaningful for this engine on a graph with a negative cycle.
+        }
+
+        if (distances.size() != reference.size())
+        {
+            return "wrong number of distances";
+        }
+
+        for (size_t v = 0; v < reference.size(); v++)
+        {
+            // Not reachable from start: engines may leave different garbage there. The reference also marks vertices affected by
+            // unreachable cycles, which engines seeing only reachable cycles solve as usual.
+            if (reference[v] >= INF / 2 || (engine.ReachableCyclesOnly && (!reachable[v] || reference[v] == NEG_INF)))
+            {
+                continue;
+            }
+
+            if ((reference[v] == NEG_INF) != (distances[v] == NEG_INF))
+            {
+                return "cycle membership differs at vertex " + to_string(v);
+            }
+
+            if (fabs(reference[v] - distances[v]) > _tolerance * max(1.0, fabs(reference[v])))
+            {
+                return "distance differs at vertex " + to_string(v);
+            }
+        }
+
+        if (engine.MarksCycleVertices)
+        {
+            for (int v : cycle)
+            {
+                if (distances[v] != NEG_INF)
+                {
+                    return "cycle vertex " + to_string(v) + " not marked";
+                }
+            }
+        }
+
+        return "";
+    }
+};
+
+#endif
@@ -0,0 +1,236 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Top_K_Screen_H
+#define Top_K_Screen_H
+
+#include <algorithm>
+#include "pathFindingBase.h"
+#include "bellmanFordAlgorithm.h"
+
+/// <summary>
+/// Screening graph of a dense matrix: only the K most favorable (smallest weight) out-edges of every vertex.
+///
+/// A negative cycle of the screen is a negative cycle of the full graph, found with V * K edges per pass instead of V^2.
+/// If the screen has no negative cycle, its Bellman-Ford distances d are checked against all the edges of the full graph in one
+/// pass: when every reduced cost w + d[from] - d[to] is non-negative, d proves the full graph has no negative cycle either.
+/// Only when that check fails does the search escalate to the full graph.
+///
+/// Every vertex keeps its K best edges in a max-heap (worst kept edge on top), updated on ticks: a dropped edge that gets better
+/// than the top replaces it, and a kept edge that gets worse marks the vertex for a row rescan before the next search.
+/// </summary>
+class TopKScreen
+{
+public:
+    /// <summary>
+    /// K is clamped to at least 1: the heaps of kept edges must not be empty.
+    /// </summary>
+    TopKScreen(int edgesPerVertex)
+        : _edgesPerVertex(max(1, edgesPerVertex))
+    {
+    }
+
+    void Build(const Graph& graph)
+    {
+        int verticesNumber = graph.Matrix.size();
+        _best.assign(verticesNumber, {});
+        _dirty.assign(verticesNumber, 0);
+        for (int from = 0; from < verticesNumber; from++)
+        {
+            _RebuildRow(graph, from);
+        }
+    }
+
+    /// <summary>
+    /// Applies the updates to the graph and to the screen.
+    /// </summary>
+    void OnTick(Graph& graph, const vector<EdgeUpdate>& updates)
+    {
+        for (const EdgeUpdate& update : updates)
+        {
+            graph.Matrix[update.From][update.To] = update.Weight;
+            if (update.From == update.To || _dirty[update.From])
+            {
+                continue;
+            }
+
+            vector<pair<double, int>>& heap = _best[update.From];
+            auto kept = find_if(heap.begin(), heap.end(), [&update](const pair<double, int>& edge) { return edge.second == update.To; });
+            if (kept != heap.end())
+            {
+                if (update.Weight <= kept->first)
+                {
+                    kept->first = update.Weight; // Still among the best: only the heap order changes.
+                    make_heap(heap.begin(), heap.end());
+                }
+                else
+                {
+                    _dirty[update.From] = 1; // Some dropped edge may be better now.
+                }
+            }
+            else if (update.Weight != INF && ((int)heap.size() < _edgesPerVertex || update.Weight < heap.front().first))
+            {
+                if ((int)heap.size() == _edgesPerVertex)
+                {
+                    pop_heap(heap.begin(), heap.end());
+                    heap.pop_back();
+                }
+                heap.push_back({ update.Weight, update.To });
+                push_heap(heap.begin(), heap.end());
+            }
+        }
+    }
+
+    /// <summary>
+    /// Returns a negative cycle of the graph in edge order, or empty vector if there is none.
+    /// </summary>
+    vector<int> FindNegativeCycle(Graph& graph)
+    {
+        int verticesNumber = graph.Matrix.size();
+        _searches++;
+        for (int from = 0; from < verticesNumber; from++)
+        {
+            if (_dirty[from])
+            {
+                _RebuildRow(graph, from);
+            }
+        }
+
+        vector<int> cycle = _ScreenNegativeCycle(verticesNumber);
+        if (!cycle.empty())
+        {
+            return cycle;
+        }
+
+        // Screen distances as potentials of the full graph.
+        for (int from = 0; from < verticesNumber; from++)
+        {
+            for (int to = 0; to < verticesNumber; to++)
+            {
+                if (graph.Matrix[from][to] != INF && graph.Matrix[from][to] + _distance[from] - _distance[to] < 0)
+                {
+                    _escalations++;
+                    return _solver.FindAnyNegativeCycle(graph);
+                }
+            }
+        }
+
+        return {};
+    }
+
+    size_t ScreenEdges() const
+    {
+        size_t edges = 0;
+        for (const vector<pair<double, int>>& heap : _best)
+        {
+            edges += heap.size();
+        }
+        return edges;
+    }
+
+    int Searches() const
+    {
+        return _searches;
+    }
+
+    int Escalations() const
+    {
+        return _escalations;
+    }
+
+private:
+    int _edgesPerVertex;
+    int _searches = 0;
+    int _escalations = 0;
+    vector<vector<pair<double, int>>> _best; // Per vertex max-heap of (weight, to).
+    vector<char> _dirty;
+    vector<double> _distance;
+    vector<int> _previousVertex;
+    BellmanFordAlgorithm _solver;
+
+    void _RebuildRow(const Graph& graph, int from)
+    {
+        vector<pair<double, int>>& heap = _best[from];
+        heap.clear();
+        for (int to = 0; to < (int)graph.Matrix.size(); to++)
+        {
+            double weight = graph.Matrix[from][to];
+            if (to == from || weight == INF)
+            {
+                continue;
+            }
+
+            if ((int)heap.size() < _edgesPerVertex)
+            {
+                heap.push_back({ weight, to });
+                push_heap(heap.begin(), heap.end());
+            }
+            else if (weight < heap.front().first)
+            {
+                pop_heap(heap.begin(), heap.end());
+                heap.back() = { weight, to };
+                push_heap(heap.begin(), heap.end());
+            }
+        }
+        _dirty[from] = 0;
+    }
+
+    /// <summary>
+    /// Bellman-Ford on the screen edges from a virtual vertex connected to all vertices; cycle extraction like FindNegativeCycle.
+    /// </summary>
+    vector<int> _ScreenNegativeCycle(int verticesNumber)
+    {
+        _distance.assign(verticesNumber, 0.0);
+        _previousVertex.assign(verticesNumber, -1);
+        if (verticesNumber == 0)
+        {
+            return {};
+        }
+
+        int lastUpdated = -1;
+        for (int k = 0; k < verticesNumber; k++)
+        {
+            lastUpdated = -1;
+            for (int from = 0; from < verticesNumber; from++)
+            {
+                for (const pair<double, int>& edge : _best[from])
+                {
+                    if (_distance[edge.second] > _distance[from] + edge.first)
+                    {
+                        _distance[edge.second] = _distance[from] + edge.first;
+                        _previousVertex[edge.second] = from;
+                        lastUpdated = edge.second;
+                    }
+                }
+            }
+
+            if (lastUpdated == -1)
+            {
+                return {};
+            }
+        }
+
+        int at = lastUpdated;
+        for (int i = 0; i < verticesNumber; i++)
+        {
+            at = _previousVertex[at];
+        }
+
+        vector<int> cycle;
+        for (int v = at; ; v = _previousVertex[v])
+        {
+            cycle.push_back(v);
+            if (v == at && cycle.size() > 1)
+            {
+                cycle.pop_back();
+                break;
+            }
+        }
+        reverse(cycle.begin(), cycle.end());
+
+        return cycle;
+    }
+};
+
+#endif
@@ -0,0 +1,102 @@
+// Copyright (C) 2023 Anton "optiklab" Yarkov
+// https://github.com/optiklab/graph-negative-cycles
+// See LICENSE file in the repo.
+#pragma once
+#ifndef Vertex_Queue_H
+#define Vertex_Queue_H
+
+#include "pathFindingBase.h"
+
+/// <summary>
+/// Queue of vertices for label-correcting solvers: a ring buffer of capacity V + 1 allocated once by Reset, plus an in-queue
+/// bitmap, so a vertex is kept at most once (pushing an enqueued vertex does nothing). Memory is bounded by V no matter how
+/// many times distances improve, and push/pop never allocate.
+/// Both ends are open for pushing, so the same queue serves FIFO and deque disciplines.
+/// </summary>
+class VertexQueue
+{
+public:
+    void Reset(int verticesNumber)
+    {
+        _buffer.resize(verticesNumber + 1);
+        _queued.assign(verticesNumber, 0);
+        _head = 0;
+        _tail = 0;
+        _size = 0;
+    }
+
+    bool Empty() const
+    {
+        return _size == 0;
+    }
+
+    int Size() const
+    {
+        return _size;
+    }
+
+    bool Contains(int v) const
+    {
+        return _queued[v] != 0;
+    }
+
+    int Front() const
+    {
+        return _buffer[_head];
+    }
+
+    /// <summary>
+    /// Returns false if the vertex is already in the queue.
+    /// </summary>
+    bool PushBack(int v)
+    {
+        if (_queued[v])
+        {
+            return false;
+        }
+        _queued[v] = 1;
+        _buffer[_tail] = v;
+        _tail = _Next(_tail);
+        _size++;
+        return true;
+    }
+
+    /// <summary>
+    /// Returns false if the vertex is already in the queue.
+    /// </summary>
+    bool PushFront(int v)
+    {
+        if (_queued[v])
+        {
+            return false;
+        }
+        _queued[v] = 1;
+        _head = _head == 0 ? (int)_buffer.size() - 1 : _head - 1;
+        _buffer[_head] = v;
+        _size++;
+        return true;
+    }
+
+    int PopFront()
+    {
+        int v = _buffer[_head];
+        _head = _Next(_head);
+        _queued[v] = 0;
+        _size--;
+        return v;
+    }
+
+private:
+    vector<int> _buffer;
+    vector<char> _queued;
+    int _head = 0;
+    int _tail = 0;
+    int _size = 0;
+
+    int _Next(int index) const
+    {
+        return index + 1 == (int)_buffer.size() ? 0 : index + 1;
+    }
+};
+
+#endif